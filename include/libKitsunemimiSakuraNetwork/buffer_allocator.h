@@ -0,0 +1,52 @@
+/**
+ * @file       buffer_allocator.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_BUFFER_ALLOCATOR_H
+#define KITSUNEMIMI_SAKURA_NETWORK_BUFFER_ALLOCATOR_H
+
+#include <libKitsunemimiCommon/buffer/data_buffer.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief interface for the allocation of the data-buffers for incoming messages, which can be
+ *        set in the session-controller to replace the internal buffer-pool
+ */
+class BufferAllocator
+{
+public:
+    virtual ~BufferAllocator() {}
+
+    // get an empty buffer with at least the requested number of bytes
+    virtual DataBuffer* allocateBuffer(const uint64_t size) = 0;
+
+    // give a buffer back, which was created by allocateBuffer
+    virtual void releaseBuffer(DataBuffer* buffer) = 0;
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_BUFFER_ALLOCATOR_H
@@ -28,6 +28,9 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <future>
 
 #include <libKitsunemimiCommon/logger.h>
 #include <libKitsunemimiCommon/statemachine.h>
@@ -44,6 +47,8 @@ class SessionHandler;
 class SessionController;
 class InternalSessionInterface;
 class MultiblockIO;
+class BufferPool;
+class SendScheduler;
 struct CommonMessageHeader;
 
 class Session
@@ -59,21 +64,145 @@ public:
     bool sendNormalMessage(const void* data,
                            const uint64_t size,
                            ErrorContainer &error);
+    bool sendNormalMessage(const void* data,
+                           const uint64_t size,
+                           uint64_t &multiblockId,
+                           ErrorContainer &error);
+    bool sendResumableMessage(const void* data,
+                              const uint64_t size,
+                              uint64_t &multiblockId,
+                              ErrorContainer &error);
+    DataBuffer* sendRequest(const void* data,
+                            const uint64_t size,
+                            const uint64_t timeout,
+                            ErrorContainer &error);
     DataBuffer* sendRequest(const void* data,
                             const uint64_t size,
                             const uint64_t timeout,
+                            uint64_t &requestId,
+                            ErrorContainer &error);
+    DataBuffer* sendRequest(const void* data,
+                            const uint64_t size,
+                            const std::chrono::milliseconds timeout,
+                            ErrorContainer &error);
+    DataBuffer* sendRequest(const void* data,
+                            const uint64_t size,
+                            const std::chrono::milliseconds timeout,
+                            uint64_t &requestId,
                             ErrorContainer &error);
     uint64_t sendResponse(const void* data,
                           const uint64_t size,
                           const uint64_t blockerId,
                           ErrorContainer &error);
+    uint64_t sendRequestAsync(const void* data,
+                              const uint64_t size,
+                              const uint64_t timeout,
+                              void* receiver,
+                              void (*processResponse)(void*, Session*, const uint64_t, DataBuffer*),
+                              ErrorContainer &error);
+    uint64_t sendRequestAsync(const void* data,
+                              const uint64_t size,
+                              const std::chrono::milliseconds timeout,
+                              void* receiver,
+                              void (*processResponse)(void*, Session*, const uint64_t, DataBuffer*),
+                              ErrorContainer &error);
+    std::future<DataBuffer*> sendRequestAsync(const void* data,
+                                              const uint64_t size,
+                                              const uint64_t timeout,
+                                              ErrorContainer &error);
+    std::future<DataBuffer*> sendRequestAsync(const void* data,
+                                              const uint64_t size,
+                                              const std::chrono::milliseconds timeout,
+                                              ErrorContainer &error);
+    bool abortMultiblockMessage(const uint64_t multiblockId);
+
+    // asynchronous send-messages, which are sent by a background-thread
+    uint64_t sendNormalMessageAsync(const void* data,
+                                    const uint64_t size,
+                                    void* receiver,
+                                    void (*processSendResult)(void*,
+                                                              Session*,
+                                                              const uint64_t,
+                                                              const bool,
+                                                              const uint64_t,
+                                                              ErrorContainer &),
+                                    ErrorContainer &error);
+    uint64_t sendResponseAsync(const void* data,
+                               const uint64_t size,
+                               const uint64_t blockerId,
+                               void* receiver,
+                               void (*processSendResult)(void*,
+                                                         Session*,
+                                                         const uint64_t,
+                                                         const bool,
+                                                         const uint64_t,
+                                                         ErrorContainer &),
+                               ErrorContainer &error);
+
+    // frame, which is reserved to write the payload of a message directly into the memory, which
+    // is later sent over the socket
+    struct ReservedFrame
+    {
+        void* payload = nullptr;
+        uint64_t payloadSize = 0;
+
+        // internal buffer of the frame
+        DataBuffer* buffer = nullptr;
+    };
+
+    // send-messages with reserved frames
+    bool reserveFrame(ReservedFrame &frame,
+                      const uint64_t size);
+    bool commitStreamData(ReservedFrame &frame,
+                          ErrorContainer &error,
+                          const bool replyExpected = false);
+    bool commitNormalMessage(ReservedFrame &frame,
+                             ErrorContainer &error);
+    DataBuffer* commitRequest(ReservedFrame &frame,
+                              const uint64_t timeout,
+                              ErrorContainer &error);
+    DataBuffer* commitRequest(ReservedFrame &frame,
+                              const std::chrono::milliseconds timeout,
+                              ErrorContainer &error);
+    uint64_t commitResponse(ReservedFrame &frame,
+                            const uint64_t blockerId,
+                            ErrorContainer &error);
+    void releaseFrame(ReservedFrame &frame);
+
+    // coalescing of small messages into one write
+    bool enableCoalescing(const uint64_t threshold,
+                          const uint64_t maxDelay);
+    bool disableCoalescing(ErrorContainer &error);
+    bool flush(ErrorContainer &error);
 
     // setter for changing callbacks
     void setStreamCallback(void* receiver,
                            void (*processStream)(void*, Session*, const void*, const uint64_t));
     void setRequestCallback(void* receiver,
                             void (*processRequest)(void*, Session*, const uint64_t, DataBuffer*));
+    void setRequestViewCallback(void* receiver,
+                                void (*processRequestView)(void*,
+                                                           Session*,
+                                                           const uint64_t,
+                                                           const void*,
+                                                           const uint64_t));
+    void setMultiblockAllocationCallback(void* receiver,
+                                         DataBuffer* (*allocateMultiblock)(void*,
+                                                                           Session*,
+                                                                           const uint64_t,
+                                                                           const uint64_t,
+                                                                           const bool));
+    void setMultiblockPartCallback(void* receiver,
+                                   void (*processMultiblockPart)(void*,
+                                                                 Session*,
+                                                                 const uint64_t,
+                                                                 const uint64_t,
+                                                                 const void*,
+                                                                 const uint64_t,
+                                                                 const bool));
     void setErrorCallback(void (*processError)(Session*,  const uint8_t, const std::string));
+    void setCompletionExecutor(void* executor,
+                               void (*executeCompletion)(void*, void (*)(void*), void*));
 
     // session-controlling functions
     bool closeSession(ErrorContainer &error,
@@ -81,6 +210,11 @@ public:
     uint32_t sessionId() const;
     uint32_t getMaximumSingleSize() const;
     bool isClientSide() const;
+    uint64_t getCapabilities() const;
+    bool hasCapability(const uint64_t capability) const;
+    uint32_t getNumberOfPaths();
+    DataBuffer* detachData(const void* data,
+                           const uint64_t size);
 
     enum errorCodes
     {
@@ -92,6 +226,16 @@ public:
         MULTIBLOCK_FAILED = 5,
     };
 
+    // optional features, which are negotiated with the other side while the session-handshake
+    enum capabilities
+    {
+        NO_CAPABILITY = 0x0,
+        NEGOTIATED_SINGLE_SIZE = 0x1,
+        MULTIBLOCK_CREDITS = 0x2,
+        MULTIPATH = 0x4,
+        RESUMABLE_MULTIBLOCK = 0x8,
+    };
+
     uint32_t increaseMessageIdCounter();
 
 
@@ -104,12 +248,38 @@ public:
 
     Kitsunemimi::Statemachine m_statemachine;
     AbstractSocket* m_socket = nullptr;
+    SendScheduler* m_sendScheduler = nullptr;
     MultiblockIO* m_multiblockIo = nullptr;
+    BufferPool* m_framePool = nullptr;
+    DataBuffer* m_sendBuffer = nullptr;
+
+    // additional connections for multiblock-messages. The attach-token is created by the server
+    // and has to be known by each new connection, which should be attached to the session
+    Session* m_parentSession = nullptr;
+    uint64_t m_attachToken = 0;
+    std::vector<Session*> m_paths;
+    std::mutex m_pathLock;
+
+    // coalescing
+    DataBuffer* m_coalescingBuffer = nullptr;
+    uint64_t m_coalescingThreshold = 0;
+    uint64_t m_coalescingDelay = 0;
+    std::chrono::steady_clock::time_point m_coalescingDeadline;
     uint32_t m_sessionId = 0;
     std::string m_sessionIdentifier = "";
     ErrorContainer sessionError;
 
+    // number of internal threads, which use the session outside of the lock of the session-map
+    // or which process a timeout of the session. The destructor waits until all of them are
+    // finished with the session.
+    std::atomic<uint64_t> m_activeUsers{0};
+
     int m_initState = 0;
+    bool m_legacyHandshake = false;
+    uint64_t m_localCapabilities = 0;
+    uint64_t m_capabilities = 0;
+    uint32_t m_localMaxSingleSize = 0;
+    uint32_t m_maxSingleSize = 0;
 
     // init session
     bool connectiSession(const uint32_t sessionId,
@@ -123,9 +293,35 @@ public:
     bool disconnectSession(ErrorContainer &error);
 
     bool sendHeartbeat();
+    bool isReady();
+    uint32_t getMultiblockPartSize() const;
     void initStatemachine();
+
+    // additional connections
+    void addPath(Session* path);
+    std::vector<Session*> getPaths();
+
     uint64_t getRandId();
 
+    // asynchronous sending
+    uint64_t queueMessage(const void* data,
+                          const uint64_t size,
+                          const uint64_t blockerId,
+                          const uint64_t sendId,
+                          void* receiver,
+                          void (*processSendResult)(void*,
+                                                    Session*,
+                                                    const uint64_t,
+                                                    const bool,
+                                                    const uint64_t,
+                                                    ErrorContainer &),
+                          ErrorContainer &error);
+    bool sendQueuedMessage(const void* data,
+                           const uint64_t size,
+                           const uint64_t sendId,
+                           const uint64_t blockerId,
+                           ErrorContainer &error);
+
     template<typename T>
     bool sendMessage(const T &message,
                      ErrorContainer &error)
@@ -138,14 +334,74 @@ public:
                      const uint64_t size,
                      ErrorContainer &error);
 
+    template<typename T>
+    bool sendFrame(const T &header,
+                   const void* payload,
+                   const uint64_t payloadSize,
+                   ErrorContainer &error)
+    {
+        return sendFrame(header.commonHeader, &header, sizeof(T), payload, payloadSize, error);
+    }
+
+    bool sendFrame(const CommonMessageHeader &commonHeader,
+                   const void* header,
+                   const uint64_t headerSize,
+                   const void* payload,
+                   const uint64_t payloadSize,
+                   ErrorContainer &error);
+
+    template<typename T>
+    bool sendFrameInPlace(const T &header,
+                          void* payload,
+                          const uint64_t payloadSize,
+                          ErrorContainer &error)
+    {
+        return sendFrameInPlace(header.commonHeader,
+                                &header,
+                                sizeof(T),
+                                payload,
+                                payloadSize,
+                                error);
+    }
+
+    bool sendFrameInPlace(const CommonMessageHeader &commonHeader,
+                          const void* header,
+                          const uint64_t headerSize,
+                          void* payload,
+                          const uint64_t payloadSize,
+                          ErrorContainer &error);
+
+    uint8_t* reserveCoalescedFrame(const uint64_t size);
+    bool finishCoalescedFrame(ErrorContainer &error);
+    bool flushCoalescedFrames(ErrorContainer &error);
+    void flushExpiredFrames();
+
     // callbacks
     void (*m_processCreateSession)(Session*, const std::string);
     void (*m_processCloseSession)(Session*, const std::string);
     void (*m_processStreamData)(void*, Session*, const void*, const uint64_t);
     void (*m_processRequestData)(void*, Session*, const uint64_t, DataBuffer*);
+    void (*m_processRequestView)(void*, Session*, const uint64_t, const void*, const uint64_t)
+        = nullptr;
     void (*m_processError)(Session*, const uint8_t, const std::string);
+    DataBuffer* (*m_allocateMultiblock)(void*, Session*, const uint64_t, const uint64_t, const bool)
+        = nullptr;
+    void (*m_processMultiblockPart)(void*,
+                                    Session*,
+                                    const uint64_t,
+                                    const uint64_t,
+                                    const void*,
+                                    const uint64_t,
+                                    const bool) = nullptr;
     void* m_streamReceiver = nullptr;
     void* m_standaloneReceiver = nullptr;
+    void* m_requestViewReceiver = nullptr;
+    void* m_allocationReceiver = nullptr;
+    void* m_multiblockPartReceiver = nullptr;
+
+    // executor for the callbacks of asynchronous requests
+    void (*m_executeCompletion)(void*, void (*)(void*), void*) = nullptr;
+    void* m_completionExecutor = nullptr;
 
     // counter
     std::atomic_flag m_messageIdCounter_lock = ATOMIC_FLAG_INIT;
@@ -0,0 +1,257 @@
+/**
+ * @file       session_awaitable.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_SESSION_AWAITABLE_H
+#define KITSUNEMIMI_SAKURA_NETWORK_SESSION_AWAITABLE_H
+
+// awaitables are only available for code, which is compiled with C++20 or newer, while the
+// library itself is still build with C++17
+#if __cplusplus >= 202002L
+
+#include <coroutine>
+
+#include <libKitsunemimiSakuraNetwork/session.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief resume a coroutine, which was handed over to the completion-executor of a session
+ *
+ * @param address address of the coroutine-handle
+ */
+inline void
+resumeSessionCoroutine(void* address)
+{
+    std::coroutine_handle<>::from_address(address).resume();
+}
+
+/**
+ * @brief awaitable for a request. The coroutine is suspended until the response has arrived and
+ *        is resumed by the thread of the socket or by the completion-executor of the session.
+ */
+class RequestAwaitable
+{
+public:
+    RequestAwaitable(Session* session,
+                     const void* data,
+                     const uint64_t size,
+                     const std::chrono::milliseconds timeout)
+    {
+        m_session = session;
+        m_data = data;
+        m_size = size;
+        m_timeout = timeout;
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        m_handle = handle;
+
+        // after a successful send the awaitable can already be resumed and deleted by another
+        // thread, so it is not used here anymore
+        ErrorContainer error;
+        const uint64_t requestId = m_session->sendRequestAsync(m_data,
+                                                               m_size,
+                                                               m_timeout,
+                                                               this,
+                                                               &processResponse,
+                                                               error);
+        if(requestId == 0)
+        {
+            m_response = nullptr;
+            return false;
+        }
+
+        return true;
+    }
+
+    DataBuffer* await_resume() const noexcept
+    {
+        return m_response;
+    }
+
+private:
+    Session* m_session = nullptr;
+    const void* m_data = nullptr;
+    uint64_t m_size = 0;
+    std::chrono::milliseconds m_timeout;
+    DataBuffer* m_response = nullptr;
+    std::coroutine_handle<> m_handle;
+
+    static void processResponse(void* target,
+                                Session*,
+                                const uint64_t,
+                                DataBuffer* response)
+    {
+        RequestAwaitable* awaitable = static_cast<RequestAwaitable*>(target);
+        awaitable->m_response = response;
+        awaitable->m_handle.resume();
+    }
+};
+
+/**
+ * @brief awaitable for a normal message. The coroutine is suspended until the message was sent
+ *        completely by a send-thread and is resumed by the completion-executor of the session, or
+ *        by the send-thread, if the session has no executor.
+ */
+class SendAwaitable
+{
+public:
+    SendAwaitable(Session* session,
+                  const void* data,
+                  const uint64_t size)
+    {
+        m_session = session;
+        m_data = data;
+        m_size = size;
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        m_handle = handle;
+
+        ErrorContainer error;
+        const uint64_t sendId = m_session->sendNormalMessageAsync(m_data,
+                                                                  m_size,
+                                                                  this,
+                                                                  &processSendResult,
+                                                                  error);
+        if(sendId == 0)
+        {
+            m_success = false;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool await_resume() const noexcept
+    {
+        return m_success;
+    }
+
+private:
+    Session* m_session = nullptr;
+    const void* m_data = nullptr;
+    uint64_t m_size = 0;
+    bool m_success = false;
+    std::coroutine_handle<> m_handle;
+
+    static void processSendResult(void* target,
+                                  Session* session,
+                                  const uint64_t,
+                                  const bool success,
+                                  const uint64_t,
+                                  ErrorContainer &)
+    {
+        SendAwaitable* awaitable = static_cast<SendAwaitable*>(target);
+        awaitable->m_success = success;
+
+        // the send-thread should not be blocked by the coroutine, if there is an executor
+        if(session->m_executeCompletion != nullptr)
+        {
+            session->m_executeCompletion(session->m_completionExecutor,
+                                         &resumeSessionCoroutine,
+                                         awaitable->m_handle.address());
+            return;
+        }
+
+        awaitable->m_handle.resume();
+    }
+};
+
+/**
+ * @brief send a request within a coroutine
+ *
+ * @param session pointer to the session
+ * @param data data-pointer, which must stay valid until the coroutine was resumed
+ * @param size number of bytes
+ * @param timeout time in seconds in which the response is expected
+ *
+ * @return awaitable, which gives the response as data-buffer, or nullptr in case of a timeout or
+ *         if the request failed
+ */
+inline RequestAwaitable
+request(Session* session,
+        const void* data,
+        const uint64_t size,
+        const uint64_t timeout)
+{
+    return RequestAwaitable(session, data, size, std::chrono::seconds(timeout));
+}
+
+/**
+ * @brief send a request within a coroutine
+ *
+ * @param session pointer to the session
+ * @param data data-pointer, which must stay valid until the coroutine was resumed
+ * @param size number of bytes
+ * @param timeout time in milliseconds in which the response is expected
+ *
+ * @return awaitable, which gives the response as data-buffer, or nullptr in case of a timeout or
+ *         if the request failed
+ */
+inline RequestAwaitable
+request(Session* session,
+        const void* data,
+        const uint64_t size,
+        const std::chrono::milliseconds timeout)
+{
+    return RequestAwaitable(session, data, size, timeout);
+}
+
+/**
+ * @brief send a normal message within a coroutine
+ *
+ * @param session pointer to the session
+ * @param data data-pointer, which must stay valid until the coroutine was resumed
+ * @param size number of bytes
+ *
+ * @return awaitable, which gives true, if the message was sent completely, else false
+ */
+inline SendAwaitable
+sendNormalMessage(Session* session,
+                  const void* data,
+                  const uint64_t size)
+{
+    return SendAwaitable(session, data, size);
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // __cplusplus >= 202002L
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_SESSION_AWAITABLE_H
@@ -29,6 +29,7 @@
 #include <atomic>
 
 #include <libKitsunemimiSakuraNetwork/session.h>
+#include <libKitsunemimiSakuraNetwork/buffer_allocator.h>
 
 namespace Kitsunemimi
 {
@@ -62,6 +63,18 @@ public:
     bool closeServer(const uint32_t id);
     void cloesAllServers();
 
+    // settings
+    bool setMaximumSingleSize(const uint32_t maxSingleSize);
+    bool setMultiblockLimits(const uint64_t maxSessionMemory,
+                             const uint64_t maxTotalMemory,
+                             const uint32_t idleTimeout);
+    bool setReplyTimeout(const uint8_t messageType,
+                         const uint32_t timeout);
+
+    // buffer-allocation
+    bool setBufferAllocator(BufferAllocator* allocator);
+    void releaseBuffer(DataBuffer* buffer);
+
     // session
     Session* startUnixDomainSession(const std::string &socketFile,
                                     const std::string &sessionIdentifier,
@@ -80,12 +93,34 @@ public:
                                 const std::string &threadName,
                                 ErrorContainer &error);
 
+    // additional connections of a session
+    bool addUnixDomainPath(Session* session,
+                           const std::string &socketFile,
+                           const std::string &threadName,
+                           ErrorContainer &error);
+    bool addTcpPath(Session* session,
+                    const std::string &address,
+                    const uint16_t port,
+                    const std::string &threadName,
+                    ErrorContainer &error);
+    bool addTlsTcpPath(Session* session,
+                       const std::string &address,
+                       const uint16_t port,
+                       const std::string &certFile,
+                       const std::string &keyFile,
+                       const std::string &threadName,
+                       ErrorContainer &error);
+
 private:
     uint32_t m_serverIdCounter = 0;
 
     Session* startSession(AbstractSocket* socket,
                           const std::string &sessionIdentifier,
-                          ErrorContainer &error);
+                          ErrorContainer &error,
+                          Session* parentSession = nullptr);
+    bool addPath(Session* session,
+                 AbstractSocket* socket,
+                 ErrorContainer &error);
 };
 
 } // namespace Sakura
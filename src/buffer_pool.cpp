@@ -0,0 +1,157 @@
+/**
+ * @file       buffer_pool.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "buffer_pool.h"
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief constructor
+ *
+ * @param maxCachedBytes maximum number of bytes, which are hold by unused buffers within the pool
+ */
+BufferPool::BufferPool(const uint64_t maxCachedBytes)
+{
+    m_maxCachedBytes = maxCachedBytes;
+}
+
+/**
+ * @brief destructor
+ */
+BufferPool::~BufferPool()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    for(uint32_t i = 0; i < NUMBER_OF_SIZE_CLASSES; i++)
+    {
+        for(uint64_t j = 0; j < m_freeBuffers[i].size(); j++) {
+            delete m_freeBuffers[i][j];
+        }
+        m_freeBuffers[i].clear();
+    }
+
+    m_cachedBytes = 0;
+}
+
+/**
+ * @brief get a buffer from the pool, which is big enough for the requested size. If there is no
+ *        unused buffer of the required size-class, a new one is allocated.
+ *
+ * @param size minimum number of bytes of the buffer
+ *
+ * @return pointer to an empty buffer
+ */
+DataBuffer*
+BufferPool::allocateBuffer(const uint64_t size)
+{
+    uint64_t numberOfBlocks = calcBytesToBlocks(size);
+    if(numberOfBlocks == 0) {
+        numberOfBlocks = 1;
+    }
+
+    // buffers, which are bigger than the biggest size-class, are not cached
+    const uint32_t sizeClass = getSizeClass(numberOfBlocks);
+    if(sizeClass >= NUMBER_OF_SIZE_CLASSES) {
+        return new DataBuffer(numberOfBlocks);
+    }
+
+    // try to reuse an old buffer
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        std::vector<DataBuffer*>* freeBuffers = &m_freeBuffers[sizeClass];
+        if(freeBuffers->size() > 0)
+        {
+            DataBuffer* buffer = freeBuffers->back();
+            freeBuffers->pop_back();
+            m_cachedBytes -= buffer->numberOfBlocks * buffer->blockSize;
+            buffer->usedBufferSize = 0;
+            return buffer;
+        }
+    }
+
+    return new DataBuffer(1ul << sizeClass);
+}
+
+/**
+ * @brief give a buffer back to the pool. If the pool is already full or the buffer doesn't match
+ *        one of the size-classes, the buffer is deleted.
+ *
+ * @param buffer buffer to release
+ */
+void
+BufferPool::releaseBuffer(DataBuffer* buffer)
+{
+    if(buffer == nullptr) {
+        return;
+    }
+
+    // check if the buffer was created by the pool
+    const uint32_t sizeClass = getSizeClass(buffer->numberOfBlocks);
+    if(sizeClass >= NUMBER_OF_SIZE_CLASSES
+            || (1ul << sizeClass) != buffer->numberOfBlocks)
+    {
+        delete buffer;
+        return;
+    }
+
+    const uint64_t bufferSize = buffer->numberOfBlocks * buffer->blockSize;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        if(m_cachedBytes + bufferSize <= m_maxCachedBytes)
+        {
+            m_freeBuffers[sizeClass].push_back(buffer);
+            m_cachedBytes += bufferSize;
+            return;
+        }
+    }
+
+    delete buffer;
+}
+
+/**
+ * @brief get the size-class for a number of blocks
+ *
+ * @param numberOfBlocks number of blocks
+ *
+ * @return index of the smallest size-class, which can hold the given number of blocks
+ */
+uint32_t
+BufferPool::getSizeClass(const uint64_t numberOfBlocks) const
+{
+    uint32_t sizeClass = 0;
+    while((1ul << sizeClass) < numberOfBlocks
+          && sizeClass < NUMBER_OF_SIZE_CLASSES)
+    {
+        sizeClass++;
+    }
+
+    return sizeClass;
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,63 @@
+/**
+ * @file       buffer_pool.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_BUFFER_POOL_H
+#define KITSUNEMIMI_SAKURA_NETWORK_BUFFER_POOL_H
+
+#include <vector>
+#include <mutex>
+
+#include <libKitsunemimiCommon/buffer/data_buffer.h>
+#include <libKitsunemimiSakuraNetwork/buffer_allocator.h>
+
+// size-classes of the pool, which are powers of two of the number of blocks (4 KiB to 8 MiB)
+#define NUMBER_OF_SIZE_CLASSES 12
+#define DEFAULT_MAX_CACHED_BYTES (16*1024*1024)
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class BufferPool
+        : public BufferAllocator
+{
+public:
+    BufferPool(const uint64_t maxCachedBytes = DEFAULT_MAX_CACHED_BYTES);
+    ~BufferPool();
+
+    DataBuffer* allocateBuffer(const uint64_t size);
+    void releaseBuffer(DataBuffer* buffer);
+
+private:
+    std::mutex m_lock;
+    std::vector<DataBuffer*> m_freeBuffers[NUMBER_OF_SIZE_CLASSES];
+    uint64_t m_cachedBytes = 0;
+    uint64_t m_maxCachedBytes = 0;
+
+    uint32_t getSizeClass(const uint64_t numberOfBlocks) const;
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_BUFFER_POOL_H
@@ -122,7 +122,8 @@ processMessage(void* target,
     }
 
     // check version in header
-    if(header->version != 0x1)
+    if(header->version < MIN_PROTOCOL_VERSION
+            || header->version > MAX_PROTOCOL_VERSION)
     {
         ErrorContainer error;
         send_ErrorMessage(session, Session::errorCodes::FALSE_VERSION, "", error);
@@ -131,6 +132,19 @@ processMessage(void* target,
         return 0;
     }
 
+    // a message, which doesn't fit into the ringbuffer, would never be complete and would block
+    // all following messages, so the session is closed
+    if(header->totalMessageSize > recvBuffer->totalBufferSize)
+    {
+        createHeaderError("message too big for the receive-buffer", header);
+
+        ErrorContainer error;
+        send_ErrorMessage(session, Session::errorCodes::INVALID_MESSAGE_SIZE, "", error);
+        session->closeSession(error);
+        LOG_ERROR(error);
+        return 0;
+    }
+
     // get complete message from the ringbuffer, if enough data are available
     const void* rawMessage = getDataPointer_RingBuffer(*recvBuffer, header->totalMessageSize);
     if(rawMessage == nullptr) {
@@ -198,6 +212,10 @@ processMessage_callback(void* target,
                         RingBuffer* recvBuffer,
                         AbstractSocket*)
 {
+    // the thread of the socket must never wait for credits of multiblock-messages, because the
+    // credit-messages are processed by the same thread
+    MultiblockIO::m_isSocketThread = true;
+
     return processMessage(target, recvBuffer);
 }
 
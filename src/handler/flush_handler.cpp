@@ -0,0 +1,189 @@
+/**
+ * @file       flush_handler.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <handler/flush_handler.h>
+
+#include <algorithm>
+
+#include <libKitsunemimiSakuraNetwork/session.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+// interval in microseconds, while there is no session in coalescing-mode
+#define IDLE_FLUSH_INTERVAL 10000
+
+// minimum interval in microseconds, so very small delays don't let the thread spin
+#define MIN_FLUSH_INTERVAL 100
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+thread_local bool FlushHandler::m_isFlushThread = false;
+
+/**
+ * @brief constructor
+ */
+FlushHandler::FlushHandler()
+    : Kitsunemimi::Thread("FlushHandler")
+{
+    m_interval = IDLE_FLUSH_INTERVAL;
+}
+
+/**
+ * @brief destructor
+ */
+FlushHandler::~FlushHandler()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_sessions.clear();
+}
+
+/**
+ * @brief register a session in coalescing-mode to flush its buffered messages after their
+ *        deadline
+ *
+ * @param session pointer to the session
+ */
+void
+FlushHandler::addSession(Session* session)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    for(uint64_t i = 0; i < m_sessions.size(); i++)
+    {
+        if(m_sessions[i] == session) {
+            return;
+        }
+    }
+
+    m_sessions.push_back(session);
+    updateInterval();
+}
+
+/**
+ * @brief remove a session from the handler and wait, until the session is not flushed by the
+ *        thread anymore, so the session can be deleted afterwards
+ *
+ * @param session pointer to the session
+ */
+void
+FlushHandler::removeSession(Session* session)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    std::vector<Session*>::iterator it;
+    for(it = m_sessions.begin();
+        it != m_sessions.end();
+        it++)
+    {
+        if(*it == session)
+        {
+            m_sessions.erase(it);
+            break;
+        }
+    }
+
+    updateInterval();
+
+    // the flush-thread itself can not wait for its own flush
+    if(m_isFlushThread == false) {
+        m_flushCondition.wait(lock, [&] { return m_flushingSession != session; });
+    }
+}
+
+/**
+ * @brief thread-loop to flush the buffered messages of all sessions, which reached their deadline
+ */
+void
+FlushHandler::run()
+{
+    m_isFlushThread = true;
+
+    while(m_abort == false)
+    {
+        m_lock.lock();
+        const uint64_t interval = m_interval;
+        m_lock.unlock();
+
+        sleepThread(static_cast<uint32_t>(interval));
+
+        if(m_abort) {
+            break;
+        }
+
+        flushSessions();
+    }
+}
+
+/**
+ * @brief flush the expired messages of all registered sessions. The sessions are flushed without
+ *        lock, so a blocking write doesn't block the registration of other sessions.
+ */
+void
+FlushHandler::flushSessions()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    const std::vector<Session*> sessions = m_sessions;
+
+    for(uint64_t i = 0; i < sessions.size(); i++)
+    {
+        // the session could be removed, while another session was flushed
+        Session* session = sessions[i];
+        if(std::find(m_sessions.begin(), m_sessions.end(), session) == m_sessions.end()) {
+            continue;
+        }
+
+        m_flushingSession = session;
+        lock.unlock();
+
+        session->flushExpiredFrames();
+
+        lock.lock();
+        m_flushingSession = nullptr;
+        m_flushCondition.notify_all();
+    }
+}
+
+/**
+ * @brief update the interval of the thread-loop to the smallest delay of all registered sessions.
+ *        The lock must be hold by the caller.
+ */
+void
+FlushHandler::updateInterval()
+{
+    m_interval = IDLE_FLUSH_INTERVAL;
+
+    for(uint64_t i = 0; i < m_sessions.size(); i++)
+    {
+        // check two times within the delay to keep the maximum latency near the delay
+        const uint64_t delay = std::max(m_sessions[i]->m_coalescingDelay / 2,
+                                        static_cast<uint64_t>(MIN_FLUSH_INTERVAL));
+        if(delay < m_interval) {
+            m_interval = delay;
+        }
+    }
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,69 @@
+/**
+ * @file       flush_handler.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_FLUSH_HANDLER_H
+#define KITSUNEMIMI_SAKURA_NETWORK_FLUSH_HANDLER_H
+
+#include <vector>
+#include <iostream>
+#include <mutex>
+#include <condition_variable>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+class Session;
+
+class FlushHandler
+        : public Kitsunemimi::Thread
+{
+public:
+    FlushHandler();
+    ~FlushHandler();
+
+    void addSession(Session* session);
+    void removeSession(Session* session);
+
+protected:
+    void run();
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_flushCondition;
+    std::vector<Session*> m_sessions;
+    uint64_t m_interval = 0;
+
+    // session, which is flushed at the moment by the thread without lock
+    Session* m_flushingSession = nullptr;
+    static thread_local bool m_isFlushThread;
+
+    void flushSessions();
+    void updateInterval();
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_FLUSH_HANDLER_H
@@ -21,18 +21,64 @@
  */
 
 #include "message_blocker_handler.h"
+#include <handler/session_handler.h>
+#include <handler/timer_handler.h>
 #include <libKitsunemimiSakuraNetwork/session.h>
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 namespace Kitsunemimi
 {
 namespace Sakura
 {
 
+/**
+ * @brief wait at the futex-word as long as it has the expected value
+ */
+inline void
+futexWait(std::atomic<uint32_t>* word,
+          const uint32_t expected)
+{
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(word),
+            FUTEX_WAIT_PRIVATE,
+            expected,
+            nullptr,
+            nullptr,
+            0);
+}
+
+/**
+ * @brief wake one thread, which waits at the futex-word
+ */
+inline void
+futexWake(std::atomic<uint32_t>* word)
+{
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(word),
+            FUTEX_WAKE_PRIVATE,
+            1,
+            nullptr,
+            nullptr,
+            0);
+}
+
+/**
+ * @brief release a blocked thread, which waits for its entry
+ */
+inline void
+wakeBlocked(std::atomic<uint32_t>* word)
+{
+    word->store(1, std::memory_order_release);
+    futexWake(word);
+}
+
 /**
  * @brief constructor
  */
-MessageBlockerHandler::MessageBlockerHandler()
-    : Kitsunemimi::Thread("MessageBlockerHandler") {}
+MessageBlockerHandler::MessageBlockerHandler() {}
 
 /**
  * @brief destructor
@@ -40,40 +86,93 @@ MessageBlockerHandler::MessageBlockerHandler()
 MessageBlockerHandler::~MessageBlockerHandler()
 {
     clearList();
+
+    // released threads and completions, which were given to an executor, still use the handler
+    // to give their entries back to the pools
+    while(m_activeUsers.load(std::memory_order_acquire) != 0) {
+        usleep(100);
+    }
+
+    // delete unused entries of the pools
+    for(uint32_t i = 0; i < NUMBER_OF_BLOCKER_SHARDS; i++)
+    {
+        MessageBlocker* blocker = m_shards[i].freeList;
+        while(blocker != nullptr)
+        {
+            MessageBlocker* next = blocker->nextFree;
+            delete blocker;
+            blocker = next;
+        }
+        m_shards[i].freeList = nullptr;
+    }
 }
 
 /**
- * @brief MessageBlockerHandler::blockMessage
+ * @brief register a request, for which the calling thread later waits with waitForMessage. The
+ *        request has to be registered before it is sent, so a fast response can not get lost.
  *
  * @param blockerId id ot identify the entry within the blocker-handler
- * @param blockerTimeout time until a timeout appear for the message in seconds
+ * @param blockerTimeout time until a timeout appear for the message in milliseconds
  * @param session pointer to the session for error-callback in case of a timeout
- * @return
  */
-DataBuffer*
-MessageBlockerHandler::blockMessage(const uint64_t blockerId,
-                                    const uint64_t blockerTimeout,
-                                    Session* session)
+void
+MessageBlockerHandler::addBlockedMessage(const uint64_t blockerId,
+                                         const uint64_t blockerTimeout,
+                                         Session* session)
 {
-    // init new blocker entry
-    MessageBlocker* messageBlocker = new MessageBlocker();
+    MessageBlockerShard* shard = getShard(blockerId);
+
+    shard->lock.lock();
+    MessageBlocker* messageBlocker = createEntry(shard);
     messageBlocker->blockerId = blockerId;
-    messageBlocker->timer = blockerTimeout;
     messageBlocker->session = session;
+    messageBlocker->timerHandle = SessionHandler::m_timerHandler->addTimer(blockerTimeout,
+                                                                           this,
+                                                                           &processTimeout,
+                                                                           blockerId);
+    shard->messages.insert(std::make_pair(blockerId, messageBlocker));
+    shard->lock.unlock();
+}
+
+/**
+ * @brief block the calling thread until the response of a request, which was registered by
+ *        addBlockedMessage, was received, or until the request failed
+ *
+ * @param blockerId id ot identify the entry within the blocker-handler
+ *
+ * @return response as data-buffer, or nullptr in case of a timeout or if the request failed
+ */
+DataBuffer*
+MessageBlockerHandler::waitForMessage(const uint64_t blockerId)
+{
+    MessageBlockerShard* shard = getShard(blockerId);
 
-    // add to waiting-list
-    spinLock();
-    m_messageList.push_back(messageBlocker);
-    spinUnlock();
+    m_activeUsers.fetch_add(1, std::memory_order_acq_rel);
+
+    shard->lock.lock();
+    std::unordered_map<uint64_t, MessageBlocker*>::iterator it = shard->messages.find(blockerId);
+    if(it == shard->messages.end())
+    {
+        shard->lock.unlock();
+        m_activeUsers.fetch_sub(1, std::memory_order_acq_rel);
+        return nullptr;
+    }
+    MessageBlocker* messageBlocker = it->second;
+    shard->lock.unlock();
+
+    // the entry stays within the table until the blocked thread removes it by itself, so the
+    // pointer remains valid while waiting
+    while(messageBlocker->released.load(std::memory_order_acquire) == 0) {
+        futexWait(&messageBlocker->released, 0);
+    }
 
-    // release thread
-    std::unique_lock<std::mutex> lock(messageBlocker->cvMutex);
-    messageBlocker->cv.wait(lock);
+    shard->lock.lock();
+    shard->messages.erase(blockerId);
+    DataBuffer* result = messageBlocker->responseData;
+    shard->lock.unlock();
 
-    // remove from list and return result
-    spinLock();
-    DataBuffer* result = removeMessageFromList(blockerId);
-    spinUnlock();
+    releaseEntry(messageBlocker);
+    m_activeUsers.fetch_sub(1, std::memory_order_acq_rel);
 
     return result;
 }
@@ -82,158 +181,406 @@ MessageBlockerHandler::blockMessage(const uint64_t blockerId,
  * @brief MessageBlockerHandler::releaseMessage
  * @param blockerId
  * @param data data-buffer, which comes from the other side and should be returned by the
- *             blocked thread, which called the request-method within the session
+ *             blocked thread, which called the request-method within the session, or given to
+ *             the callback of an asynchronous request
  *
- * @return true, if blocker-id was found in the list of blocked threads
+ * @return true, if blocker-id was found in the table of pending requests
  */
 bool
 MessageBlockerHandler::releaseMessage(const uint64_t blockerId,
                                       DataBuffer* data)
 {
     bool result = false;
+    std::vector<MessageBlocker*> completedMessages;
+    MessageBlockerShard* shard = getShard(blockerId);
 
-    spinLock();
-    result = releaseMessageInList(blockerId, data);
-    spinUnlock();
+    shard->lock.lock();
+    result = releaseMessageInShard(shard, blockerId, data, completedMessages);
+    shard->lock.unlock();
+
+    // callbacks of asynchronous requests are called without lock
+    for(uint64_t i = 0; i < completedMessages.size(); i++) {
+        completeMessage(completedMessages[i]);
+    }
 
     return result;
 }
 
 /**
- * @brief AnswerHandler::run
+ * @brief register an asynchronous request, which response is given to a callback instead of a
+ *        blocked thread. The request has to be registered before it is sent, so a fast response
+ *        can not get lost.
+ *
+ * @param blockerId id ot identify the entry within the blocker-handler
+ * @param blockerTimeout time until a timeout appear for the message in milliseconds
+ * @param session pointer to the session for error-callback in case of a timeout
+ * @param receiver pointer, which is given to the callback
+ * @param processResponse callback for the response, which gets nullptr in case of a timeout or
+ *                        if the request failed
  */
 void
-MessageBlockerHandler::run()
+MessageBlockerHandler::addAsyncMessage(const uint64_t blockerId,
+                                       const uint64_t blockerTimeout,
+                                       Session* session,
+                                       void* receiver,
+                                       void (*processResponse)(void*,
+                                                               Session*,
+                                                               const uint64_t,
+                                                               DataBuffer*))
 {
-    while(m_abort == false)
-    {
-        makeTimerStep();
+    MessageBlockerShard* shard = getShard(blockerId);
 
-        // sleep for 1 second
-        sleepThread(1000000);
-    }
+    shard->lock.lock();
+    MessageBlocker* messageBlocker = createEntry(shard);
+    messageBlocker->blockerId = blockerId;
+    messageBlocker->session = session;
+    messageBlocker->receiver = receiver;
+    messageBlocker->processResponse = processResponse;
+    messageBlocker->timerHandle = SessionHandler::m_timerHandler->addTimer(blockerTimeout,
+                                                                           this,
+                                                                           &processTimeout,
+                                                                           blockerId);
+    shard->messages.insert(std::make_pair(blockerId, messageBlocker));
+    shard->lock.unlock();
 }
 
 /**
- * @brief MessageBlockerHandler::releaseMessageInList
+ * @brief remove a request, which could not be sent, without calling its callback
  *
- * @param blockerId
- * @param data
- *
- * @return
+ * @param blockerId id ot identify the entry within the blocker-handler
  */
-bool
-MessageBlockerHandler::releaseMessageInList(const uint64_t blockerId,
-                                            DataBuffer* data)
+void
+MessageBlockerHandler::cancelMessage(const uint64_t blockerId)
 {
-    std::vector<MessageBlocker*>::iterator it;
-    for(it = m_messageList.begin();
-        it != m_messageList.end();
-        it++)
+    MessageBlockerShard* shard = getShard(blockerId);
+    MessageBlocker* messageBlocker = nullptr;
+
+    shard->lock.lock();
+    std::unordered_map<uint64_t, MessageBlocker*>::iterator it = shard->messages.find(blockerId);
+    if(it != shard->messages.end())
     {
-        MessageBlocker* tempItem = *it;
-        if(tempItem->blockerId == blockerId)
-        {
-            tempItem->responseData = data;
-            tempItem->cv.notify_one();
-            return true;
-        }
+        messageBlocker = it->second;
+        shard->messages.erase(it);
+        SessionHandler::m_timerHandler->cancelTimer(messageBlocker->timerHandle);
     }
+    shard->lock.unlock();
 
-    return false;
+    if(messageBlocker != nullptr) {
+        releaseEntry(messageBlocker);
+    }
 }
 
 /**
- * @brief AnswerHandler::removeMessageFromList
- * @param blockerId
- * @return
+ * @brief release all requests of a session, which is closed. Blocked threads return nullptr and
+ *        callbacks of asynchronous requests get nullptr.
+ *
+ * @param session pointer to the session
  */
-DataBuffer*
-MessageBlockerHandler::removeMessageFromList(const uint64_t blockerId)
+void
+MessageBlockerHandler::removeAllOfSession(Session* session)
 {
-    std::vector<MessageBlocker*>::iterator it;
-    for(it = m_messageList.begin();
-        it != m_messageList.end();
-        it++)
+    std::vector<MessageBlocker*> completedMessages;
+
+    for(uint32_t i = 0; i < NUMBER_OF_BLOCKER_SHARDS; i++)
     {
-        MessageBlocker* tempItem = *it;
-        if(tempItem->blockerId == blockerId)
+        MessageBlockerShard* shard = &m_shards[i];
+        shard->lock.lock();
+
+        std::unordered_map<uint64_t, MessageBlocker*>::iterator it = shard->messages.begin();
+        while(it != shard->messages.end())
         {
-            if(m_messageList.size() > 1)
+            MessageBlocker* tempItem = it->second;
+            if(tempItem->session != session)
             {
-                // swap with last and remove the last instead of erase the element direct
-                // because this was is faster
-                std::iter_swap(it, m_messageList.end() - 1);
-                m_messageList.pop_back();
+                it++;
+                continue;
             }
-            else
+
+            if(tempItem->processResponse != nullptr)
             {
-                m_messageList.clear();
+                SessionHandler::m_timerHandler->cancelTimer(tempItem->timerHandle);
+                it = shard->messages.erase(it);
+                completedMessages.push_back(tempItem);
+                continue;
             }
 
-            // get data-buffer from the blocker-entry and delete the entry afterwards
-            DataBuffer* result = tempItem->responseData;
-            tempItem->responseData = nullptr;
-            delete tempItem;
-
-            return result;
+            // blocked threads remove their entry by themself and entries within a timeout are
+            // released by the timer
+            if(tempItem->released.load(std::memory_order_relaxed) == 0
+                    && tempItem->timedOut == false)
+            {
+                SessionHandler::m_timerHandler->cancelTimer(tempItem->timerHandle);
+                tempItem->responseData = nullptr;
+                wakeBlocked(&tempItem->released);
+            }
+            it++;
         }
+
+        shard->lock.unlock();
     }
 
-    return nullptr;
+    for(uint64_t j = 0; j < completedMessages.size(); j++) {
+        completeMessage(completedMessages[j]);
+    }
 }
 
 /**
- * @brief AnswerHandler::clearList
+ * @brief get the part of the table, which contains the entry of a blocker-id
+ *
+ * @param blockerId id ot identify the entry within the blocker-handler
+ *
+ * @return pointer to the shard
+ */
+MessageBlockerHandler::MessageBlockerShard*
+MessageBlockerHandler::getShard(const uint64_t blockerId)
+{
+    return &m_shards[blockerId % NUMBER_OF_BLOCKER_SHARDS];
+}
+
+/**
+ * @brief take an unused entry from the pool of the shard or create a new one, if the pool is
+ *        empty. The lock of the shard must be hold by the caller.
+ *
+ * @param shard shard, where the entry is used
+ *
+ * @return pointer to the resetted entry
+ */
+MessageBlockerHandler::MessageBlocker*
+MessageBlockerHandler::createEntry(MessageBlockerShard* shard)
+{
+    MessageBlocker* blocker = shard->freeList;
+    if(blocker != nullptr) {
+        shard->freeList = blocker->nextFree;
+    } else {
+        blocker = new MessageBlocker();
+    }
+
+    blocker->session = nullptr;
+    blocker->handler = this;
+    blocker->blockerId = 0;
+    blocker->timerHandle = 0;
+    blocker->responseData = nullptr;
+    blocker->released.store(0, std::memory_order_relaxed);
+    blocker->timedOut = false;
+    blocker->receiver = nullptr;
+    blocker->processResponse = nullptr;
+    blocker->nextFree = nullptr;
+
+    return blocker;
+}
+
+/**
+ * @brief give an entry, which was already removed from the table, back to the pool of its shard
+ *
+ * @param blocker entry to release
  */
 void
-MessageBlockerHandler::clearList()
+MessageBlockerHandler::releaseEntry(MessageBlocker* blocker)
 {
-    spinLock();
+    MessageBlockerShard* shard = getShard(blocker->blockerId);
 
-    // release all threads
-    std::vector<MessageBlocker*>::iterator it;
-    for(it = m_messageList.begin();
-        it != m_messageList.end();
-        it++)
+    shard->lock.lock();
+    blocker->nextFree = shard->freeList;
+    shard->freeList = blocker;
+    shard->lock.unlock();
+}
+
+/**
+ * @brief MessageBlockerHandler::releaseMessageInShard
+ *
+ * @param shard shard, which contains the entry of the blocker-id
+ * @param blockerId
+ * @param data
+ * @param completedMessages reference for asynchronous requests, which are removed from the table
+ *                          and have to be completed after the lock was released
+ *
+ * @return
+ */
+bool
+MessageBlockerHandler::releaseMessageInShard(MessageBlockerShard* shard,
+                                             const uint64_t blockerId,
+                                             DataBuffer* data,
+                                             std::vector<MessageBlocker*> &completedMessages)
+{
+    std::unordered_map<uint64_t, MessageBlocker*>::iterator it = shard->messages.find(blockerId);
+    if(it == shard->messages.end()) {
+        return false;
+    }
+
+    MessageBlocker* tempItem = it->second;
+
+    if(tempItem->processResponse != nullptr)
     {
-        MessageBlocker* tempItem = *it;
-        tempItem->cv.notify_one();
-        delete tempItem;
+        SessionHandler::m_timerHandler->cancelTimer(tempItem->timerHandle);
+        tempItem->responseData = data;
+        shard->messages.erase(it);
+        completedMessages.push_back(tempItem);
+        return true;
     }
 
-    // clear list
-    m_messageList.clear();
+    // entry was already released by a timeout, but the blocked thread has not removed it yet
+    if(tempItem->released.load(std::memory_order_relaxed) != 0
+            || tempItem->timedOut)
+    {
+        return false;
+    }
 
-    spinUnlock();
+    SessionHandler::m_timerHandler->cancelTimer(tempItem->timerHandle);
+    tempItem->responseData = data;
+    wakeBlocked(&tempItem->released);
+
+    return true;
 }
 
 /**
- * @brief MessageBlockerHandler::makeTimerStep
+ * @brief give the response of an asynchronous request to its callback. If the session has an
+ *        executor for completions, the callback is called by the executor, else directly by the
+ *        current thread.
+ *
+ * @param blocker entry of the request, which is given back to the pool after the callback
  */
 void
-MessageBlockerHandler::makeTimerStep()
+MessageBlockerHandler::completeMessage(MessageBlocker* blocker)
 {
-    spinLock();
+    blocker->handler->m_activeUsers.fetch_add(1, std::memory_order_acq_rel);
 
-    for(uint64_t i = 0; i < m_messageList.size(); i++)
+    Session* session = blocker->session;
+    if(session->m_executeCompletion != nullptr)
     {
-        MessageBlocker* temp = m_messageList[i];
-        temp->timer -= 1;
+        session->m_executeCompletion(session->m_completionExecutor, &runCompletion, blocker);
+        return;
+    }
+
+    runCompletion(blocker);
+}
+
+/**
+ * @brief call the callback of an asynchronous request and give its entry back to the pool
+ *
+ * @param blocker entry of the request
+ */
+void
+MessageBlockerHandler::runCompletion(void* blocker)
+{
+    MessageBlocker* messageBlocker = static_cast<MessageBlocker*>(blocker);
+    messageBlocker->processResponse(messageBlocker->receiver,
+                                    messageBlocker->session,
+                                    messageBlocker->blockerId,
+                                    messageBlocker->responseData);
+    MessageBlockerHandler* handler = messageBlocker->handler;
+    handler->releaseEntry(messageBlocker);
+    handler->m_activeUsers.fetch_sub(1, std::memory_order_acq_rel);
+}
 
-        if(temp->timer == 0)
+/**
+ * @brief AnswerHandler::clearList. This is only called, when the timer-handler is already deleted,
+ *        so the timers of the entries are not canceled.
+ */
+void
+MessageBlockerHandler::clearList()
+{
+    std::vector<MessageBlocker*> completedMessages;
+
+    for(uint32_t i = 0; i < NUMBER_OF_BLOCKER_SHARDS; i++)
+    {
+        MessageBlockerShard* shard = &m_shards[i];
+        shard->lock.lock();
+
+        // release all threads
+        std::unordered_map<uint64_t, MessageBlocker*>::iterator it;
+        for(it = shard->messages.begin();
+            it != shard->messages.end();
+            it++)
         {
-            removeMessageFromList(temp->blockerId);
-            releaseMessageInList(temp->blockerId, nullptr);
+            MessageBlocker* tempItem = it->second;
+            tempItem->responseData = nullptr;
+
+            if(tempItem->processResponse != nullptr)
+            {
+                completedMessages.push_back(tempItem);
+                continue;
+            }
 
-            const std::string err = "TIMEOUT of request: " + std::to_string(temp->blockerId);
-            temp->session->m_processError(temp->session,
-                                          Session::errorCodes::MESSAGE_TIMEOUT,
-                                          err);
+            // blocked threads still use their entry, so it is not deleted here
+            wakeBlocked(&tempItem->released);
         }
+
+        // clear table
+        shard->messages.clear();
+
+        shard->lock.unlock();
+    }
+
+    for(uint64_t i = 0; i < completedMessages.size(); i++)
+    {
+        m_activeUsers.fetch_add(1, std::memory_order_acq_rel);
+        runCompletion(completedMessages[i]);
+    }
+}
+
+/**
+ * @brief handle the timeout of a request, which is called by the timer-handler
+ *
+ * @param target pointer to the blocker-handler
+ * @param blockerId id of the request without response
+ */
+void
+MessageBlockerHandler::processTimeout(void* target,
+                                      const uint64_t blockerId)
+{
+    MessageBlockerHandler* handler = static_cast<MessageBlockerHandler*>(target);
+    MessageBlockerShard* shard = handler->getShard(blockerId);
+    MessageBlocker* completedMessage = nullptr;
+
+    shard->lock.lock();
+
+    // the response could have been arrived while the timer expired
+    std::unordered_map<uint64_t, MessageBlocker*>::iterator it = shard->messages.find(blockerId);
+    if(it == shard->messages.end()
+            || it->second->released.load(std::memory_order_relaxed) != 0
+            || it->second->timedOut)
+    {
+        shard->lock.unlock();
+        return;
+    }
+
+    MessageBlocker* temp = it->second;
+    Session* session = temp->session;
+    temp->responseData = nullptr;
+
+    // the destructor of the session waits until the error-callback was called
+    session->m_activeUsers++;
+
+    if(temp->processResponse != nullptr)
+    {
+        shard->messages.erase(it);
+        completedMessage = temp;
+    }
+    else
+    {
+        // the blocked thread is released after the error-callback, so the session can not be
+        // closed by the application while it is still used here
+        temp->timedOut = true;
+    }
+
+    shard->lock.unlock();
+
+    // the error-callback has to be called before the request is completed, because the
+    // completion of the request can lead to the deletion of the session
+    const std::string err = "TIMEOUT of request: " + std::to_string(blockerId);
+    session->m_processError(session, Session::errorCodes::MESSAGE_TIMEOUT, err);
+    session->m_activeUsers--;
+
+    if(completedMessage != nullptr)
+    {
+        completeMessage(completedMessage);
+        return;
     }
 
-    spinUnlock();
+    // blocked threads remove their entry by themself
+    shard->lock.lock();
+    wakeBlocked(&temp->released);
+    shard->lock.unlock();
 }
 
 } // namespace Sakura
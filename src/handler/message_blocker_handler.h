@@ -25,8 +25,11 @@
 
 #include <vector>
 #include <iostream>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
-#include <libKitsunemimiCommon/threading/thread.h>
+#include <libKitsunemimiCommon/buffer/data_buffer.h>
 
 namespace Kitsunemimi
 {
@@ -34,40 +37,79 @@ namespace Sakura
 {
 class Session;
 
+// number of independent parts of the table of pending requests. The part of a request is
+// selected by its blocker-id, so responses for different requests don't block each other.
+#define NUMBER_OF_BLOCKER_SHARDS 64
+
 class MessageBlockerHandler
-        : public Kitsunemimi::Thread
 {
 public:
     MessageBlockerHandler();
     ~MessageBlockerHandler();
 
-    DataBuffer* blockMessage(const uint64_t blockerId,
-                             const uint64_t blockerTimeout,
-                             Session* session);
+    // blocking requests
+    void addBlockedMessage(const uint64_t blockerId,
+                           const uint64_t blockerTimeout,
+                           Session* session);
+    DataBuffer* waitForMessage(const uint64_t blockerId);
     bool releaseMessage(const uint64_t blockerId,
                         DataBuffer* data);
 
-protected:
-    void run();
+    // asynchronous requests
+    void addAsyncMessage(const uint64_t blockerId,
+                         const uint64_t blockerTimeout,
+                         Session* session,
+                         void* receiver,
+                         void (*processResponse)(void*, Session*, const uint64_t, DataBuffer*));
+    void cancelMessage(const uint64_t blockerId);
+    void removeAllOfSession(Session* session);
 
 private:
     struct MessageBlocker
     {
         Session* session = nullptr;
+        MessageBlockerHandler* handler = nullptr;
         uint64_t blockerId = 0;
-        uint64_t timer = 0;
-        std::mutex cvMutex;
-        std::condition_variable cv;
+        uint64_t timerHandle = 0;
         DataBuffer* responseData = nullptr;
+
+        // word of the futex, where the blocked thread waits (0 = waiting, 1 = released)
+        std::atomic<uint32_t> released;
+
+        // true, while the timeout of a blocking request is processed
+        bool timedOut = false;
+
+        // callback of an asynchronous request instead of a blocked thread
+        void* receiver = nullptr;
+        void (*processResponse)(void*, Session*, const uint64_t, DataBuffer*) = nullptr;
+
+        // next unused entry within the pool of the shard
+        MessageBlocker* nextFree = nullptr;
     };
 
-    std::vector<MessageBlocker*> m_messageList;
+    struct alignas(64) MessageBlockerShard
+    {
+        std::mutex lock;
+        std::unordered_map<uint64_t, MessageBlocker*> messages;
+        MessageBlocker* freeList = nullptr;
+    };
+
+    MessageBlockerShard m_shards[NUMBER_OF_BLOCKER_SHARDS];
+
+    // number of blocked threads and running completions, which still use the handler
+    std::atomic<uint64_t> m_activeUsers{0};
 
-    bool releaseMessageInList(const uint64_t blockerId,
-                              DataBuffer* data);
-    DataBuffer* removeMessageFromList(const uint64_t blockerId);
+    MessageBlockerShard* getShard(const uint64_t blockerId);
+    MessageBlocker* createEntry(MessageBlockerShard* shard);
+    void releaseEntry(MessageBlocker* blocker);
+    bool releaseMessageInShard(MessageBlockerShard* shard,
+                               const uint64_t blockerId,
+                               DataBuffer* data,
+                               std::vector<MessageBlocker*> &completedMessages);
+    static void completeMessage(MessageBlocker* blocker);
+    static void runCompletion(void* blocker);
+    static void processTimeout(void* target, const uint64_t blockerId);
     void clearList();
-    void makeTimerStep();
 };
 
 } // namespace Sakura
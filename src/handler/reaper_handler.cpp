@@ -0,0 +1,71 @@
+/**
+ * @file       reaper_handler.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <handler/reaper_handler.h>
+#include <handler/session_handler.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+// interval in microseconds to send heartbeats and to check for idle partial multiblock-messages
+#define REAPER_INTERVAL (HEARTBEAT_INTERVAL * 1000)
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief constructor
+ */
+ReaperHandler::ReaperHandler()
+    : Kitsunemimi::Thread("ReaperHandler") {}
+
+/**
+ * @brief destructor
+ */
+ReaperHandler::~ReaperHandler() {}
+
+/**
+ * @brief thread-loop to send heartbeats, to remove partial multiblock-messages, which didn't get
+ *        new parts for too long, and parked messages, which are older than the grace-period
+ */
+void
+ReaperHandler::run()
+{
+    while(m_abort == false)
+    {
+        sleepThread(REAPER_INTERVAL);
+
+        if(m_abort
+                || SessionHandler::m_sessionHandler == nullptr)
+        {
+            break;
+        }
+
+        SessionHandler::m_sessionHandler->sendHeartBeats();
+        SessionHandler::m_sessionHandler->removeIdleMultiblockBuffers();
+        SessionHandler::m_sessionHandler->removeExpiredMultiblockBuffers();
+    }
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,49 @@
+/**
+ * @file       reaper_handler.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_REAPER_HANDLER_H
+#define KITSUNEMIMI_SAKURA_NETWORK_REAPER_HANDLER_H
+
+#include <iostream>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class ReaperHandler
+        : public Kitsunemimi::Thread
+{
+public:
+    ReaperHandler();
+    ~ReaperHandler();
+
+protected:
+    void run();
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_REAPER_HANDLER_H
@@ -23,6 +23,8 @@
 #include <handler/reply_handler.h>
 #include <handler/message_blocker_handler.h>
 #include <handler/session_handler.h>
+#include <handler/timer_handler.h>
+#include <messages_processing/session_processing.h>
 
 #include <libKitsunemimiSakuraNetwork/session.h>
 
@@ -38,9 +40,10 @@ namespace Sakura
  * @brief constructor
  */
 ReplyHandler::ReplyHandler()
-    : Kitsunemimi::Thread("ReplyHandler")
 {
-    m_messageList.reserve(10);
+    for(uint32_t i = 0; i < 256; i++) {
+        m_timeouts[i] = DEFAULT_REPLY_TIMEOUT;
+    }
 }
 
 /**
@@ -48,9 +51,19 @@ ReplyHandler::ReplyHandler()
  */
 ReplyHandler::~ReplyHandler()
 {
-    spinLock();
-    m_messageList.clear();
-    spinUnlock();
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::unordered_map<uint64_t, MessageTime>::iterator it;
+    for(it = m_messages.begin();
+        it != m_messages.end();
+        it++)
+    {
+        if(SessionHandler::m_timerHandler != nullptr) {
+            SessionHandler::m_timerHandler->cancelTimer(it->second.timerHandle);
+        }
+    }
+
+    m_messages.clear();
 }
 
 /**
@@ -87,9 +100,13 @@ ReplyHandler::addMessage(const uint8_t messageType,
     messageTime.messageType = messageType;
     messageTime.session = session;
 
-    spinLock();
-    m_messageList.push_back(messageTime);
-    spinUnlock();
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    messageTime.timerHandle = SessionHandler::m_timerHandler->addTimer(m_timeouts[messageType],
+                                                                       this,
+                                                                       &processTimeout,
+                                                                       completeMessageId);
+    m_messages[completeMessageId] = messageTime;
 }
 
 /**
@@ -117,141 +134,117 @@ ReplyHandler::removeMessage(const uint32_t sessionId,
 bool
 ReplyHandler::removeMessage(const uint64_t completeMessageId)
 {
-    bool result = false;
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::unordered_map<uint64_t, MessageTime>::iterator it = m_messages.find(completeMessageId);
+    if(it == m_messages.end()) {
+        return false;
+    }
 
-    spinLock();
-    result = removeMessageFromList(completeMessageId);
-    spinUnlock();
+    SessionHandler::m_timerHandler->cancelTimer(it->second.timerHandle);
+    m_messages.erase(it);
 
-    return result;
+    return true;
 }
 
 /**
- * @brief remove all messages from the internal message, which are related to a specific session
+ * @brief remove all messages from the internal list, which are related to a specific session,
+ *        and cancel their timers
  *
- * @param sessionId id of the session
+ * @param session pointer to the session
  */
 void
-ReplyHandler::removeAllOfSession(const uint32_t sessionId)
+ReplyHandler::removeAllOfSession(Session* session)
 {
-    spinLock();
+    std::lock_guard<std::mutex> guard(m_lock);
 
-    std::vector<MessageTime>::iterator it;
-    for(it = m_messageList.begin();
-        it != m_messageList.end();
-        it++)
+    std::unordered_map<uint64_t, MessageTime>::iterator it = m_messages.begin();
+    while(it != m_messages.end())
     {
-        if((it->completeMessageId & 0xFFFFFFFF) == sessionId) {
-            it->ignoreResult = true;
+        if(it->second.session != session)
+        {
+            it++;
+            continue;
         }
-    }
 
-    spinUnlock();
+        SessionHandler::m_timerHandler->cancelTimer(it->second.timerHandle);
+        it = m_messages.erase(it);
+    }
 }
 
 /**
- * @brief remove a message from the internal list
+ * @brief set the time, in which the reply for messages of a specific type is expected. This only
+ *        affects messages, which are sent afterwards.
  *
- * @param messageId id of the message, which should be removed
- *
- * @return false, if message-id doesn't exist in the list, else true
+ * @param messageType type of the message
+ * @param timeout time in milliseconds
  */
-bool
-ReplyHandler::removeMessageFromList(const uint64_t completeMessageId)
+void
+ReplyHandler::setTimeout(const uint8_t messageType,
+                         const uint32_t timeout)
 {
-    std::vector<MessageTime>::iterator it;
-    for(it = m_messageList.begin();
-        it != m_messageList.end();
-        it++)
-    {
-        if(it->completeMessageId == completeMessageId)
-        {
-            if(m_messageList.size() > 1)
-            {
-                // swap with last and remove the last instead of erase the element direct
-                // because this was is faster
-                std::iter_swap(it, m_messageList.end() - 1);
-                m_messageList.pop_back();
-            }
-            else
-            {
-                m_messageList.clear();
-            }
-
-            return true;
-        }
-    }
-
-    return false;
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_timeouts[messageType] = timeout;
 }
 
 /**
- * @brief endless thread-loop the heartbeat timer
+ * @brief handle the timeout of a message, which is called by the timer-handler
+ *
+ * @param target pointer to the reply-handler
+ * @param completeMessageId id of the message without reply
  */
 void
-ReplyHandler::run()
+ReplyHandler::processTimeout(void* target,
+                             const uint64_t completeMessageId)
 {
-    uint32_t counter = 0;
+    ReplyHandler* replyHandler = static_cast<ReplyHandler*>(target);
 
-    while(m_abort == false)
+    // the reply could have been arrived while the timer expired
+    replyHandler->m_lock.lock();
+    std::unordered_map<uint64_t, MessageTime>::iterator it =
+            replyHandler->m_messages.find(completeMessageId);
+    if(it == replyHandler->m_messages.end())
     {
-        sleepThread(100000);
-        counter += 1;
-
-        if(m_abort) {
-            break;
-        }
-
-        if(counter % 10 == 0)
-        {
-            makeTimerStep();
-
-            SessionHandler::m_sessionHandler->sendHeartBeats();
-            counter = 0;
-        }
+        replyHandler->m_lock.unlock();
+        return;
     }
-}
-
-/**
- * @brief Increase the timer of all messages and handle timeouts
- */
-void
-ReplyHandler::makeTimerStep()
-{
-    spinLock();
-
-    for(uint64_t i = 0; i < m_messageList.size(); i++)
+    const MessageTime timedOut = it->second;
+    Session* session = timedOut.session;
+    replyHandler->m_messages.erase(it);
+
+    // the destructor of the session waits until the timeout is processed
+    session->m_activeUsers++;
+    replyHandler->m_lock.unlock();
+
+    // a peer with an old version silently drops the compact init-message, so
+    // in this case the session-init is retried with the old fixed-size message
+    if(timedOut.messageType == SESSION_TYPE
+            && session->m_initState == 0
+            && session->m_legacyHandshake == false
+            && session->isClientSide())
     {
-        MessageTime* temp = &m_messageList[i];
-        temp->timer += 1.0f;
-
-        if(temp->timer >= m_timeoutValue)
-        {
-            spinUnlock();
-            removeMessage(temp->completeMessageId);
-            if(temp->ignoreResult == false)
-            {
-                const std::string err = "TIMEOUT of message: "
-                                        + std::to_string(temp->completeMessageId)
-                                        + " with type: "
-                                        + std::to_string(temp->messageType);
-                // release session for the case,
-                // that the session is actually still in creating state.
-                // If this lock is not release, it blocks for eterity.
-                temp->session->m_initState = -1;
-
-                temp->session->m_processError(temp->session,
-                                              Session::errorCodes::MESSAGE_TIMEOUT,
-                                              err);
-            }
-
-            spinLock();
-
-            break;
-        }
+        LOG_WARNING("no reply for compact session-init, retry with legacy-message");
+        session->m_legacyHandshake = true;
+        send_Session_Init_Start(session,
+                                session->m_sessionIdentifier,
+                                session->sessionError);
+        session->m_activeUsers--;
+        return;
     }
 
-    spinUnlock();
+    const std::string err = "TIMEOUT of message: "
+                            + std::to_string(timedOut.completeMessageId)
+                            + " with type: "
+                            + std::to_string(timedOut.messageType);
+    // release session for the case,
+    // that the session is actually still in creating state.
+    // If this lock is not release, it blocks for eterity.
+    session->m_initState = -1;
+
+    session->m_processError(session,
+                            Session::errorCodes::MESSAGE_TIMEOUT,
+                            err);
+    session->m_activeUsers--;
 }
 
 } // namespace Sakura
@@ -25,8 +25,8 @@
 
 #include <vector>
 #include <iostream>
-
-#include <libKitsunemimiCommon/threading/thread.h>
+#include <mutex>
+#include <unordered_map>
 
 namespace Kitsunemimi
 {
@@ -35,7 +35,6 @@ namespace Sakura
 class Session;
 
 class ReplyHandler
-        : public Kitsunemimi::Thread
 {
 public:
     ReplyHandler();
@@ -54,26 +53,27 @@ public:
     bool removeMessage(const uint32_t sessionId,
                        const uint64_t messageId);
     bool removeMessage(const uint64_t completeMessageId);
-    void removeAllOfSession(const uint32_t sessionId);
+    void removeAllOfSession(Session* session);
 
-protected:
-    void run();
+    // settings
+    void setTimeout(const uint8_t messageType,
+                    const uint32_t timeout);
 
 private:
     struct MessageTime
     {
         uint64_t completeMessageId = 0;
-        float timer = 0.0f;
+        uint64_t timerHandle = 0;
         uint8_t messageType = 0;
         Session* session = nullptr;
-        bool ignoreResult = false;
     };
 
-    float m_timeoutValue = 2.0f;
-    std::vector<MessageTime> m_messageList;
+    std::mutex m_lock;
+    std::unordered_map<uint64_t, MessageTime> m_messages;
+    uint32_t m_timeouts[256];
 
-    void makeTimerStep();
-    bool removeMessageFromList(const uint64_t completeMessageId);
+    static void processTimeout(void* target,
+                               const uint64_t completeMessageId);
 };
 
 } // namespace Sakura
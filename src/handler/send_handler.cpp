@@ -0,0 +1,90 @@
+/**
+ * @file       send_handler.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <handler/send_handler.h>
+
+#include <libKitsunemimiSakuraNetwork/session.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+// interval in microseconds to check for the end of the thread, while there is no job
+#define SEND_HANDLER_IDLE_INTERVAL 100000
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief constructor
+ *
+ * @param sendQueue queue, which is shared by all send-threads
+ */
+SendHandler::SendHandler(SendQueue* sendQueue)
+    : Kitsunemimi::Thread("SendHandler")
+{
+    m_sendQueue = sendQueue;
+}
+
+/**
+ * @brief destructor
+ */
+SendHandler::~SendHandler() {}
+
+/**
+ * @brief thread-loop to send the queued messages. Messages of one session are sent in the order,
+ *        in which they were added.
+ */
+void
+SendHandler::run()
+{
+    while(m_abort == false)
+    {
+        SendQueue::SendJob job;
+        if(m_sendQueue->takeJob(job, SEND_HANDLER_IDLE_INTERVAL) == false) {
+            continue;
+        }
+
+        processJob(job);
+        m_sendQueue->finishJob(job);
+    }
+}
+
+/**
+ * @brief send a queued message and give the result to the callback of the job
+ *
+ * @param job message to send
+ */
+void
+SendHandler::processJob(SendQueue::SendJob &job)
+{
+    ErrorContainer error;
+    const bool success = job.session->sendQueuedMessage(job.data,
+                                                        job.size,
+                                                        job.sendId,
+                                                        job.blockerId,
+                                                        error);
+    SendQueue::reportResult(job, success, error);
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
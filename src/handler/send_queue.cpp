@@ -0,0 +1,253 @@
+/**
+ * @file       send_queue.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <handler/send_queue.h>
+
+#include <libKitsunemimiSakuraNetwork/session.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+// maximum time in milliseconds to wait for a send-thread, which sends a message of a session,
+// which is closed
+#define SEND_QUEUE_REMOVE_TIMEOUT 10000
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+thread_local Session* SendQueue::m_currentSession = nullptr;
+
+/**
+ * @brief constructor
+ */
+SendQueue::SendQueue() {}
+
+/**
+ * @brief destructor
+ */
+SendQueue::~SendQueue()
+{
+    std::map<Session*, std::deque<SendJob>> jobs;
+
+    m_lock.lock();
+    m_stopped = true;
+    jobs.swap(m_jobs);
+    m_readySessions.clear();
+    m_lock.unlock();
+
+    // not sent messages are finished with an error
+    std::map<Session*, std::deque<SendJob>>::iterator it;
+    for(it = jobs.begin();
+        it != jobs.end();
+        it++)
+    {
+        for(uint64_t i = 0; i < it->second.size(); i++)
+        {
+            ErrorContainer error;
+            error.addMeesage("send-handler was closed before the message was sent");
+            reportResult(it->second[i], false, error);
+        }
+    }
+}
+
+/**
+ * @brief add a new message to the queue of its session
+ *
+ * @param job message to send
+ *
+ * @return false, if the queue is already closed, else true
+ */
+bool
+SendQueue::addJob(const SendJob &job)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if(m_stopped) {
+        return false;
+    }
+
+    std::deque<SendJob>* sessionJobs = &m_jobs[job.session];
+    sessionJobs->push_back(job);
+
+    // a session, which is sent at the moment, is added again, when its message is finished
+    if(sessionJobs->size() == 1
+            && m_activeSessions.find(job.session) == m_activeSessions.end())
+    {
+        m_readySessions.push_back(job.session);
+        m_jobCondition.notify_one();
+    }
+
+    return true;
+}
+
+/**
+ * @brief take the next message of the session, which waits the longest time. Only one message of
+ *        a session is sent at the same time to keep their order, but messages of different
+ *        sessions are sent by different threads, so a big message doesn't block other sessions.
+ *
+ * @param job reference for the message to send
+ * @param waitTime maximum time in microseconds to wait for a message
+ *
+ * @return false, if there was no message within the wait-time, else true
+ */
+bool
+SendQueue::takeJob(SendJob &job,
+                   const uint64_t waitTime)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_jobCondition.wait_for(lock,
+                            std::chrono::microseconds(waitTime),
+                            [&] { return m_readySessions.empty() == false || m_stopped; });
+    if(m_readySessions.empty()) {
+        return false;
+    }
+
+    Session* session = m_readySessions.front();
+    m_readySessions.pop_front();
+
+    std::map<Session*, std::deque<SendJob>>::iterator it = m_jobs.find(session);
+    job = it->second.front();
+    it->second.pop_front();
+    if(it->second.empty()) {
+        m_jobs.erase(it);
+    }
+
+    m_activeSessions[session] = job.sendId;
+    m_currentSession = session;
+
+    return true;
+}
+
+/**
+ * @brief mark the message of a session as finished and make the next message of the session
+ *        available for the send-threads
+ *
+ * @param job finished message
+ */
+void
+SendQueue::finishJob(const SendJob &job)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    m_activeSessions.erase(job.session);
+    m_currentSession = nullptr;
+
+    // the session could be closed by the callback of the message
+    if(m_jobs.find(job.session) != m_jobs.end())
+    {
+        m_readySessions.push_back(job.session);
+        m_jobCondition.notify_one();
+    }
+
+    m_finishCondition.notify_all();
+}
+
+/**
+ * @brief remove all queued messages of a session and wait until the message of the session,
+ *        which is currently sent, is finished. Messages, which are removed, are finished with
+ *        an error. If this is called by the send-thread of the session itself, for example by
+ *        the callback of a message, it doesn't wait.
+ *
+ * @param session pointer to the session, which is closed
+ */
+void
+SendQueue::removeAllOfSession(Session* session)
+{
+    std::deque<SendJob> removedJobs;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    std::map<Session*, std::deque<SendJob>>::iterator it = m_jobs.find(session);
+    if(it != m_jobs.end())
+    {
+        removedJobs.swap(it->second);
+        m_jobs.erase(it);
+    }
+
+    std::deque<Session*>::iterator readyIt;
+    for(readyIt = m_readySessions.begin();
+        readyIt != m_readySessions.end();)
+    {
+        if(*readyIt == session) {
+            readyIt = m_readySessions.erase(readyIt);
+        } else {
+            readyIt++;
+        }
+    }
+
+    // abort the running transfer, because the session can not send anymore
+    const std::chrono::steady_clock::time_point deadline =
+            std::chrono::steady_clock::now()
+            + std::chrono::milliseconds(SEND_QUEUE_REMOVE_TIMEOUT);
+    while(m_currentSession != session)
+    {
+        std::map<Session*, uint64_t>::const_iterator activeIt = m_activeSessions.find(session);
+        if(activeIt == m_activeSessions.end()) {
+            break;
+        }
+
+        if(std::chrono::steady_clock::now() >= deadline)
+        {
+            LOG_WARNING("send-thread didn't finish the message of a closed session in time");
+            break;
+        }
+
+        const uint64_t activeSendId = activeIt->second;
+        lock.unlock();
+        session->abortMultiblockMessage(activeSendId);
+        lock.lock();
+        m_finishCondition.wait_for(lock, std::chrono::milliseconds(1));
+    }
+
+    lock.unlock();
+
+    for(uint64_t i = 0; i < removedJobs.size(); i++)
+    {
+        ErrorContainer error;
+        error.addMeesage("session was closed before the message was sent");
+        reportResult(removedJobs[i], false, error);
+    }
+}
+
+/**
+ * @brief call the callback of a message with the result of the transfer
+ *
+ * @param job finished message
+ * @param success true, if the message was sent completely
+ * @param error reference for error-output, which is given to the callback
+ */
+void
+SendQueue::reportResult(SendJob &job,
+                        const bool success,
+                        ErrorContainer &error)
+{
+    if(job.processSendResult == nullptr) {
+        return;
+    }
+
+    const uint64_t bytesSent = success ? job.size : 0;
+    job.processSendResult(job.receiver, job.session, job.sendId, success, bytesSent, error);
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,92 @@
+/**
+ * @file       send_queue.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_SEND_QUEUE_H
+#define KITSUNEMIMI_SAKURA_NETWORK_SEND_QUEUE_H
+
+#include <iostream>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+class Session;
+
+class SendQueue
+{
+public:
+    // message, which is sent asynchronous by one of the send-threads
+    struct SendJob
+    {
+        Session* session = nullptr;
+        const void* data = nullptr;
+        uint64_t size = 0;
+        uint64_t sendId = 0;
+        uint64_t blockerId = 0;
+        void* receiver = nullptr;
+        void (*processSendResult)(void*,
+                                  Session*,
+                                  const uint64_t,
+                                  const bool,
+                                  const uint64_t,
+                                  ErrorContainer &) = nullptr;
+    };
+
+    SendQueue();
+    ~SendQueue();
+
+    bool addJob(const SendJob &job);
+    bool takeJob(SendJob &job,
+                 const uint64_t waitTime);
+    void finishJob(const SendJob &job);
+    void removeAllOfSession(Session* session);
+
+    static void reportResult(SendJob &job,
+                             const bool success,
+                             ErrorContainer &error);
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_jobCondition;
+    std::condition_variable m_finishCondition;
+
+    // queued messages of each session in the order, in which they were added
+    std::map<Session*, std::deque<SendJob>> m_jobs;
+    // sessions with queued messages, which are not sent by a thread at the moment
+    std::deque<Session*> m_readySessions;
+    // sessions, which are sent at the moment, with the send-id of their current message
+    std::map<Session*, uint64_t> m_activeSessions;
+    bool m_stopped = false;
+
+    static thread_local Session* m_currentSession;
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_SEND_QUEUE_H
@@ -24,7 +24,14 @@
 
 #include <handler/reply_handler.h>
 #include <handler/message_blocker_handler.h>
+#include <handler/flush_handler.h>
+#include <handler/reaper_handler.h>
+#include <handler/timer_handler.h>
+#include <handler/timeout_handler.h>
+#include <handler/send_handler.h>
+#include <handler/send_queue.h>
 #include <handler/session_handler.h>
+#include <buffer_pool.h>
 
 #include <libKitsunemimiSakuraNetwork/session.h>
 #include <libKitsunemimiSakuraNetwork/session_controller.h>
@@ -40,6 +47,12 @@ namespace Sakura
 // init static variables
 ReplyHandler* SessionHandler::m_replyHandler = nullptr;
 MessageBlockerHandler* SessionHandler::m_blockerHandler = nullptr;
+FlushHandler* SessionHandler::m_flushHandler = nullptr;
+ReaperHandler* SessionHandler::m_reaperHandler = nullptr;
+TimerHandler* SessionHandler::m_timerHandler = nullptr;
+TimeoutHandler* SessionHandler::m_timeoutHandler = nullptr;
+std::vector<SendHandler*> SessionHandler::m_sendHandler;
+SendQueue* SessionHandler::m_sendQueue = nullptr;
 SessionHandler* SessionHandler::m_sessionHandler = nullptr;
 
 /**
@@ -53,17 +66,51 @@ SessionHandler::SessionHandler(void (*processCreateSession)(Session*, const std:
     m_processCloseSession = processCloseSession;
     m_processError = processError;
 
+    m_bufferPool = new BufferPool();
+    m_bufferAllocator = m_bufferPool;
 
-    if(m_replyHandler == nullptr)
+    // the timer-handler has to exist before the handlers, which add timers
+    if(m_timeoutHandler == nullptr)
     {
-        m_replyHandler = new ReplyHandler();
-        m_replyHandler->startThread();
+        m_timeoutHandler = new TimeoutHandler();
+        m_timeoutHandler->startThread();
     }
 
-    if(m_blockerHandler == nullptr)
+    if(m_timerHandler == nullptr)
     {
+        m_timerHandler = new TimerHandler();
+        m_timerHandler->startThread();
+    }
+
+    if(m_replyHandler == nullptr) {
+        m_replyHandler = new ReplyHandler();
+    }
+
+    if(m_blockerHandler == nullptr) {
         m_blockerHandler = new MessageBlockerHandler();
-        m_blockerHandler->startThread();
+    }
+
+    if(m_flushHandler == nullptr)
+    {
+        m_flushHandler = new FlushHandler();
+        m_flushHandler->startThread();
+    }
+
+    if(m_reaperHandler == nullptr)
+    {
+        m_reaperHandler = new ReaperHandler();
+        m_reaperHandler->startThread();
+    }
+
+    if(m_sendHandler.size() == 0)
+    {
+        m_sendQueue = new SendQueue();
+        for(uint32_t i = 0; i < NUMBER_OF_SEND_THREADS; i++)
+        {
+            SendHandler* sendHandler = new SendHandler(m_sendQueue);
+            sendHandler->startThread();
+            m_sendHandler.push_back(sendHandler);
+        }
     }
 
     // check if messages have the size of a multiple of 8
@@ -71,16 +118,23 @@ SessionHandler::SessionHandler(void (*processCreateSession)(Session*, const std:
     assert(sizeof(CommonMessageFooter) % 8 == 0);
     assert(sizeof(Session_Init_Start_Message) % 8 == 0);
     assert(sizeof(Session_Init_Reply_Message) % 8 == 0);
+    assert(sizeof(Session_Init_Compact_Start_Header) % 8 == 0);
+    assert(sizeof(Session_Init_Compact_Reply_Header) % 8 == 0);
     assert(sizeof(Session_Close_Start_Message) % 8 == 0);
     assert(sizeof(Session_Close_Reply_Message) % 8 == 0);
     assert(sizeof(Heartbeat_Start_Message) % 8 == 0);
     assert(sizeof(Heartbeat_Reply_Message) % 8 == 0);
-    assert(sizeof(Error_FalseVersion_Message) % 8 == 0);
-    assert(sizeof(Error_UnknownSession_Message) % 8 == 0);
-    assert(sizeof(Error_InvalidMessage_Message) % 8 == 0);
+    assert(sizeof(Error_Message_Header) % 8 == 0);
     assert(sizeof(Data_StreamReply_Message) % 8 == 0);
     assert(sizeof(Data_SingleBlockReply_Message) % 8 == 0);
     assert(sizeof(Data_MultiFinish_Message) % 8 == 0);
+    assert(sizeof(Data_MultiCredit_Message) % 8 == 0);
+    assert(sizeof(Data_MultiAbort_Message) % 8 == 0);
+    assert(sizeof(Data_MultiResume_Message) % 8 == 0);
+    assert(sizeof(Data_MultiResumeReply_Header) % 8 == 0);
+    assert(sizeof(Data_Stream_Header) <= FRAME_HEADROOM);
+    assert(sizeof(Data_SingleBlock_Header) <= FRAME_HEADROOM);
+    assert(8 + sizeof(CommonMessageFooter) <= FRAME_TAILROOM);
 }
 
 /**
@@ -88,17 +142,48 @@ SessionHandler::SessionHandler(void (*processCreateSession)(Session*, const std:
  */
 SessionHandler::~SessionHandler()
 {
+    if(m_reaperHandler != nullptr)
+    {
+        m_reaperHandler->scheduleThreadForDeletion();
+        m_reaperHandler = nullptr;
+    }
+    // the send-threads are deleted before their shared queue
+    for(uint64_t i = 0; i < m_sendHandler.size(); i++) {
+        delete m_sendHandler[i];
+    }
+    m_sendHandler.clear();
+    if(m_sendQueue != nullptr)
+    {
+        delete m_sendQueue;
+        m_sendQueue = nullptr;
+    }
+    // delete the timer- and timeout-handler first, so no timeout is processed by deleted
+    // handlers
+    if(m_timerHandler != nullptr)
+    {
+        delete m_timerHandler;
+        m_timerHandler = nullptr;
+    }
+    if(m_timeoutHandler != nullptr)
+    {
+        delete m_timeoutHandler;
+        m_timeoutHandler = nullptr;
+    }
     if(m_replyHandler != nullptr)
     {
-        m_replyHandler->scheduleThreadForDeletion();
+        delete m_replyHandler;
         m_replyHandler = nullptr;
-        sleep(1);
     }
     if(m_blockerHandler != nullptr)
     {
         delete m_blockerHandler;
         m_blockerHandler = nullptr;
     }
+    if(m_flushHandler != nullptr)
+    {
+        m_flushHandler->scheduleThreadForDeletion();
+        m_flushHandler = nullptr;
+    }
 
     lockServerMap();
     m_servers.clear();
@@ -107,6 +192,21 @@ SessionHandler::~SessionHandler()
     lockSessionMap();
     m_sessions.clear();
     unlockSessionMap();
+
+    // release all parked partial multiblock-messages
+    m_parkedLock.lock();
+    std::map<ParkedKey, ParkedMultiblockBuffer>::iterator it;
+    for(it = m_parkedBuffers.begin();
+        it != m_parkedBuffers.end();
+        it++)
+    {
+        MultiblockIO::releaseIncomingData(it->second.buffer);
+    }
+    m_parkedBuffers.clear();
+    m_parkedLock.unlock();
+
+    m_bufferAllocator = nullptr;
+    delete m_bufferPool;
 }
 
 /**
@@ -127,6 +227,240 @@ SessionHandler::addSession(const uint32_t id, Session* session)
     unlockSessionMap();
 }
 
+/**
+ * @brief get a buffer for the data of an incoming message from the buffer-allocator
+ *
+ * @param size minimum number of bytes of the buffer
+ *
+ * @return pointer to an empty buffer
+ */
+DataBuffer*
+SessionHandler::allocateBuffer(const uint64_t size)
+{
+    return m_bufferAllocator->allocateBuffer(size);
+}
+
+/**
+ * @brief give a buffer of an incoming message back to the buffer-allocator
+ *
+ * @param buffer buffer to release
+ */
+void
+SessionHandler::releaseBuffer(DataBuffer* buffer)
+{
+    m_bufferAllocator->releaseBuffer(buffer);
+}
+
+/**
+ * @brief set the allocator for the buffers of incoming messages. This is refused, while a server
+ *        or a session exists, because all buffers have to be released by the same allocator,
+ *        which had created them.
+ *
+ * @param allocator new allocator or nullptr to use the internal buffer-pool again
+ *
+ * @return false, if a server, a session or a parked multiblock-message still exists, else true
+ */
+bool
+SessionHandler::setBufferAllocator(BufferAllocator* allocator)
+{
+    bool result = false;
+
+    lockServerMap();
+    lockSessionMap();
+    m_parkedLock.lock();
+
+    if(m_servers.size() == 0
+            && m_sessions.size() == 0
+            && m_parkedBuffers.size() == 0)
+    {
+        if(allocator == nullptr) {
+            m_bufferAllocator = m_bufferPool;
+        } else {
+            m_bufferAllocator = allocator;
+        }
+        result = true;
+    }
+
+    m_parkedLock.unlock();
+    unlockSessionMap();
+    unlockServerMap();
+
+    return result;
+}
+
+/**
+ * @brief keep a partial multiblock-message of a closed session for the grace-period, so the
+ *        transfer can be resumed with a new session
+ *
+ * @param sessionIdentifier identifier of the closed session
+ * @param buffer partial multiblock-message
+ */
+void
+SessionHandler::parkMultiblockBuffer(const std::string &sessionIdentifier,
+                                     const MultiblockIO::MultiblockBuffer &buffer)
+{
+    removeExpiredMultiblockBuffers();
+
+    ParkedMultiblockBuffer parked;
+    parked.parkTime = std::chrono::steady_clock::now();
+    parked.buffer = buffer;
+
+    std::lock_guard<std::mutex> guard(m_parkedLock);
+
+    // an older message with the same id is replaced, so its memory has to be released
+    const ParkedKey key(sessionIdentifier, buffer.multiblockId);
+    std::map<ParkedKey, ParkedMultiblockBuffer>::iterator it;
+    it = m_parkedBuffers.find(key);
+    if(it != m_parkedBuffers.end())
+    {
+        MultiblockIO::releaseIncomingData(it->second.buffer);
+        it->second = parked;
+        return;
+    }
+
+    m_parkedBuffers.insert(std::make_pair(key, parked));
+}
+
+/**
+ * @brief take a parked partial multiblock-message back for a resume
+ *
+ * @param sessionIdentifier identifier of the new session, which has to match the old one
+ * @param multiblockId id of the multiblock-message
+ * @param buffer reference for the partial multiblock-message
+ *
+ * @return false, if no matching message was found, else true
+ */
+bool
+SessionHandler::takeParkedMultiblockBuffer(const std::string &sessionIdentifier,
+                                           const uint64_t multiblockId,
+                                           MultiblockIO::MultiblockBuffer &buffer)
+{
+    removeExpiredMultiblockBuffers();
+
+    std::lock_guard<std::mutex> guard(m_parkedLock);
+
+    std::map<ParkedKey, ParkedMultiblockBuffer>::iterator it;
+    it = m_parkedBuffers.find(ParkedKey(sessionIdentifier, multiblockId));
+    if(it == m_parkedBuffers.end()) {
+        return false;
+    }
+
+    buffer = it->second.buffer;
+    m_parkedBuffers.erase(it);
+
+    return true;
+}
+
+/**
+ * @brief release all parked partial multiblock-messages, which are older than the grace-period
+ */
+void
+SessionHandler::removeExpiredMultiblockBuffers()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> guard(m_parkedLock);
+
+    std::map<ParkedKey, ParkedMultiblockBuffer>::iterator it;
+    for(it = m_parkedBuffers.begin();
+        it != m_parkedBuffers.end();)
+    {
+        if(now - it->second.parkTime > std::chrono::seconds(MULTIBLOCK_RESUME_GRACE_PERIOD))
+        {
+            MultiblockIO::releaseIncomingData(it->second.buffer);
+            it = m_parkedBuffers.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+/**
+ * @brief reserve memory for an incomplete incoming multiblock-message within the limit for all
+ *        sessions
+ *
+ * @param size number of bytes
+ *
+ * @return false, if the limit would be exceeded, else true
+ */
+bool
+SessionHandler::reserveMultiblockMemory(const uint64_t size)
+{
+    uint64_t used = m_usedMultiblockMemory.load();
+    do
+    {
+        if(used + size > m_maxTotalMultiblockMemory) {
+            return false;
+        }
+    }
+    while(m_usedMultiblockMemory.compare_exchange_weak(used, used + size) == false);
+
+    return true;
+}
+
+/**
+ * @brief release memory, which was reserved for an incoming multiblock-message
+ *
+ * @param size number of bytes
+ */
+void
+SessionHandler::releaseMultiblockMemory(const uint64_t size)
+{
+    m_usedMultiblockMemory -= size;
+}
+
+/**
+ * @brief get the memory, which is reserved for incoming multiblock-messages of all sessions
+ *
+ * @return number of reserved bytes
+ */
+uint64_t
+SessionHandler::getUsedMultiblockMemory() const
+{
+    return m_usedMultiblockMemory.load();
+}
+
+/**
+ * @brief remove the incomplete multiblock-messages of all sessions, which didn't get new parts
+ *        within the idle-timeout, and report them by the error-callback of their session. The
+ *        sessions are only marked as used under the lock of the session-map, so the callbacks
+ *        are free to close sessions and adding or removing sessions is not blocked.
+ */
+void
+SessionHandler::removeIdleMultiblockBuffers()
+{
+    std::vector<Session*> sessions;
+
+    lockSessionMap();
+    std::map<uint32_t, Session*>::iterator it;
+    for(it = m_sessions.begin();
+        it != m_sessions.end();
+        it++)
+    {
+        it->second->m_activeUsers++;
+        sessions.push_back(it->second);
+    }
+    unlockSessionMap();
+
+    for(uint64_t i = 0; i < sessions.size(); i++)
+    {
+        Session* session = sessions[i];
+        std::vector<std::string> errorMessages;
+        session->m_multiblockIo->removeIdleBuffers(m_multiblockIdleTimeout, errorMessages);
+
+        // the application has to know this for streamed messages and for its own buffers
+        for(uint64_t j = 0; j < errorMessages.size(); j++) {
+            session->m_processError(session,
+                                    Session::errorCodes::MULTIBLOCK_FAILED,
+                                    errorMessages[j]);
+        }
+
+        session->m_activeUsers--;
+    }
+}
+
 /**
  * @brief remove a session from the internal list, but doesn't close the session
  *
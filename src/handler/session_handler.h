@@ -27,16 +27,29 @@
 #include <vector>
 #include <map>
 #include <atomic>
+#include <mutex>
+#include <chrono>
+#include <utility>
 #include <message_definitions.h>
+#include <multiblock_io.h>
 
 namespace Kitsunemimi
 {
 class AbstractServer;
+struct DataBuffer;
 namespace Sakura
 {
 class Session;
+class BufferAllocator;
+class BufferPool;
 class ReplyHandler;
 class MessageBlockerHandler;
+class FlushHandler;
+class ReaperHandler;
+class TimerHandler;
+class TimeoutHandler;
+class SendHandler;
+class SendQueue;
 class SessionController;
 
 class SessionHandler
@@ -45,6 +58,12 @@ public:
 
     static Kitsunemimi::Sakura::ReplyHandler* m_replyHandler;
     static Kitsunemimi::Sakura::MessageBlockerHandler* m_blockerHandler;
+    static Kitsunemimi::Sakura::FlushHandler* m_flushHandler;
+    static Kitsunemimi::Sakura::ReaperHandler* m_reaperHandler;
+    static Kitsunemimi::Sakura::TimerHandler* m_timerHandler;
+    static Kitsunemimi::Sakura::TimeoutHandler* m_timeoutHandler;
+    static std::vector<Kitsunemimi::Sakura::SendHandler*> m_sendHandler;
+    static Kitsunemimi::Sakura::SendQueue* m_sendQueue;
     static Kitsunemimi::Sakura::SessionHandler* m_sessionHandler;
 
     SessionHandler(void (*processCreateSession)(Session*, const std::string),
@@ -57,6 +76,25 @@ public:
     Session* removeSession(const uint32_t id);
     void sendHeartBeats();
 
+    // buffer-allocation for incoming messages
+    DataBuffer* allocateBuffer(const uint64_t size);
+    void releaseBuffer(DataBuffer* buffer);
+    bool setBufferAllocator(BufferAllocator* allocator);
+
+    // partial multiblock-messages of closed sessions for resumable transfers
+    void parkMultiblockBuffer(const std::string &sessionIdentifier,
+                              const MultiblockIO::MultiblockBuffer &buffer);
+    bool takeParkedMultiblockBuffer(const std::string &sessionIdentifier,
+                                    const uint64_t multiblockId,
+                                    MultiblockIO::MultiblockBuffer &buffer);
+    void removeExpiredMultiblockBuffers();
+
+    // memory of incomplete incoming multiblock-messages
+    bool reserveMultiblockMemory(const uint64_t size);
+    void releaseMultiblockMemory(const uint64_t size);
+    uint64_t getUsedMultiblockMemory() const;
+    void removeIdleMultiblockBuffers();
+
     // counter
     uint16_t increaseSessionIdCounter();
 
@@ -69,6 +107,14 @@ public:
     std::map<uint32_t, Session*> m_sessions;
     std::map<uint32_t, AbstractServer*> m_servers;
 
+    // settings for new sessions
+    uint32_t m_maxSingleSize = MAX_SINGLE_MESSAGE_SIZE;
+
+    // limits for incomplete incoming multiblock-messages
+    uint64_t m_maxSessionMultiblockMemory = DEFAULT_MAX_SESSION_MULTIBLOCK_MEMORY;
+    uint64_t m_maxTotalMultiblockMemory = DEFAULT_MAX_TOTAL_MULTIBLOCK_MEMORY;
+    uint32_t m_multiblockIdleTimeout = DEFAULT_MULTIBLOCK_IDLE_TIMEOUT;
+
 private:
     // counter
     uint16_t m_sessionIdCounter = 0;
@@ -76,6 +122,22 @@ private:
     std::atomic_flag m_serverMap_lock = ATOMIC_FLAG_INIT;
     std::atomic_flag m_sessionIdCounter_lock = ATOMIC_FLAG_INIT;
 
+    // buffer-allocation
+    BufferPool* m_bufferPool = nullptr;
+    BufferAllocator* m_bufferAllocator = nullptr;
+
+    // parked partial multiblock-messages, which are identified by session-identifier and
+    // multiblock-id, because the multiblock-ids are choosen by the other sides
+    struct ParkedMultiblockBuffer
+    {
+        std::chrono::steady_clock::time_point parkTime;
+        MultiblockIO::MultiblockBuffer buffer;
+    };
+    typedef std::pair<std::string, uint64_t> ParkedKey;
+    std::mutex m_parkedLock;
+    std::map<ParkedKey, ParkedMultiblockBuffer> m_parkedBuffers;
+    std::atomic<uint64_t> m_usedMultiblockMemory{0};
+
     // callbacks
     void (*m_processCreateSession)(Session*, const std::string);
     void (*m_processCloseSession)(Session*, const std::string);
@@ -0,0 +1,93 @@
+/**
+ * @file       timeout_handler.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <handler/timeout_handler.h>
+
+// interval in microseconds to check for the end of the thread, while there is no timeout
+#define TIMEOUT_HANDLER_IDLE_INTERVAL 100000
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief constructor
+ */
+TimeoutHandler::TimeoutHandler()
+    : Kitsunemimi::Thread("TimeoutHandler") {}
+
+/**
+ * @brief destructor
+ */
+TimeoutHandler::~TimeoutHandler() {}
+
+/**
+ * @brief add expired timers, whose callbacks are called by the thread of this handler, so
+ *        callbacks, which send messages or call callbacks of the application, don't delay the
+ *        timer-thread
+ *
+ * @param expiredTimers list of expired timers
+ */
+void
+TimeoutHandler::addTimeouts(const std::vector<TimerWheel::ExpiredTimer> &expiredTimers)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    for(uint64_t i = 0; i < expiredTimers.size(); i++) {
+        m_timeouts.push_back(expiredTimers[i]);
+    }
+
+    m_timeoutCondition.notify_one();
+}
+
+/**
+ * @brief thread-loop to call the callbacks of the expired timers in the order of their expiration
+ */
+void
+TimeoutHandler::run()
+{
+    while(m_abort == false)
+    {
+        std::deque<TimerWheel::ExpiredTimer> timeouts;
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_timeoutCondition.wait_for(lock,
+                                    std::chrono::microseconds(TIMEOUT_HANDLER_IDLE_INTERVAL),
+                                    [&] { return m_timeouts.empty() == false || m_abort; });
+        timeouts.swap(m_timeouts);
+        lock.unlock();
+
+        for(uint64_t i = 0; i < timeouts.size(); i++)
+        {
+            if(m_abort) {
+                break;
+            }
+
+            TimerWheel::ExpiredTimer* timer = &timeouts[i];
+            timer->processTimeout(timer->target, timer->id);
+        }
+    }
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,62 @@
+/**
+ * @file       timeout_handler.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_TIMEOUT_HANDLER_H
+#define KITSUNEMIMI_SAKURA_NETWORK_TIMEOUT_HANDLER_H
+
+#include <iostream>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+#include <timer_wheel.h>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class TimeoutHandler
+        : public Kitsunemimi::Thread
+{
+public:
+    TimeoutHandler();
+    ~TimeoutHandler();
+
+    void addTimeouts(const std::vector<TimerWheel::ExpiredTimer> &expiredTimers);
+
+protected:
+    void run();
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_timeoutCondition;
+    std::deque<TimerWheel::ExpiredTimer> m_timeouts;
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_TIMEOUT_HANDLER_H
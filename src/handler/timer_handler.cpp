@@ -0,0 +1,128 @@
+/**
+ * @file       timer_handler.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <handler/timer_handler.h>
+#include <handler/timeout_handler.h>
+#include <handler/session_handler.h>
+
+// interval in microseconds, in which the timer-wheel is moved forward
+#define TIMER_INTERVAL 1000
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief constructor
+ */
+TimerHandler::TimerHandler()
+    : Kitsunemimi::Thread("TimerHandler")
+{
+    m_startTime = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief destructor
+ */
+TimerHandler::~TimerHandler() {}
+
+/**
+ * @brief add a new timer to the timer-wheel
+ *
+ * @param timeout time in milliseconds until the timer expires
+ * @param target pointer, which is given to the callback
+ * @param processTimeout callback, which is called by the timeout-handler, when the timer expires
+ * @param id id, which is given to the callback
+ *
+ * @return handle of the timer to cancel it
+ */
+uint64_t
+TimerHandler::addTimer(const uint64_t timeout,
+                       void* target,
+                       void (*processTimeout)(void*, const uint64_t),
+                       const uint64_t id)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_timerWheel.add(timeout, target, processTimeout, id);
+}
+
+/**
+ * @brief remove a timer from the timer-wheel
+ *
+ * @param handle handle of the timer, which was returned by addTimer
+ *
+ * @return false, if the timer has already expired or was already canceled, else true
+ */
+bool
+TimerHandler::cancelTimer(const uint64_t handle)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_timerWheel.cancel(handle);
+}
+
+/**
+ * @brief thread-loop to move the timer-wheel forward
+ */
+void
+TimerHandler::run()
+{
+    while(m_abort == false)
+    {
+        sleepThread(TIMER_INTERVAL);
+
+        if(m_abort) {
+            break;
+        }
+
+        makeTimerStep();
+    }
+}
+
+/**
+ * @brief move the timer-wheel to the current time and give all expired timers to the
+ *        timeout-handler, which calls their callbacks. So the timer-thread is not delayed by
+ *        callbacks, which send messages or call callbacks of the application.
+ */
+void
+TimerHandler::makeTimerStep()
+{
+    std::vector<TimerWheel::ExpiredTimer> expiredTimers;
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const uint64_t currentTicks = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(now - m_startTime).count());
+
+    m_lock.lock();
+    m_timerWheel.advance(currentTicks - m_processedTicks, expiredTimers);
+    m_lock.unlock();
+    m_processedTicks = currentTicks;
+
+    if(expiredTimers.size() > 0
+            && SessionHandler::m_timeoutHandler != nullptr)
+    {
+        SessionHandler::m_timeoutHandler->addTimeouts(expiredTimers);
+    }
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
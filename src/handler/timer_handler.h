@@ -0,0 +1,67 @@
+/**
+ * @file       timer_handler.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_TIMER_HANDLER_H
+#define KITSUNEMIMI_SAKURA_NETWORK_TIMER_HANDLER_H
+
+#include <iostream>
+#include <mutex>
+#include <chrono>
+
+#include <timer_wheel.h>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class TimerHandler
+        : public Kitsunemimi::Thread
+{
+public:
+    TimerHandler();
+    ~TimerHandler();
+
+    uint64_t addTimer(const uint64_t timeout,
+                      void* target,
+                      void (*processTimeout)(void*, const uint64_t),
+                      const uint64_t id);
+    bool cancelTimer(const uint64_t handle);
+
+protected:
+    void run();
+
+private:
+    std::mutex m_lock;
+    TimerWheel m_timerWheel;
+    std::chrono::steady_clock::time_point m_startTime;
+    uint64_t m_processedTicks = 0;
+
+    void makeTimerStep();
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_TIMER_HANDLER_H
@@ -39,14 +39,74 @@ namespace Sakura
 {
 
 #define PROTOCOL_IDENTIFIER 0x6e79616e
+// range of accepted versions in the common header. Outgoing messages still have version 0x1,
+// because old peers reject all other versions. Additional features are negotiated instead by the
+// capabilities within the session-handshake.
+#define MIN_PROTOCOL_VERSION 0x1
+#define MAX_PROTOCOL_VERSION 0x2
 #define MESSAGE_DELIMITER 0x70617375
-#define MESSAGE_CACHE_SIZE (1024*1024)
+#define SMALL_FRAME_SIZE (8*1024)
+// space before and after the payload of a reserved frame, which is necessary to write header,
+// padding and footer around the payload without copy of the payload
+#define FRAME_HEADROOM 64
+#define FRAME_TAILROOM 16
+#define MAX_SESSION_IDENTIFIER_SIZE 64000
+#define HANDSHAKE_VERSION 0x5
+#define MAX_ERROR_MESSAGE_SIZE (4*1024)
+
+// capabilities, which are supported by this version and offered to the other side while the
+// session-handshake
+#define SUPPORTED_CAPABILITIES 0xF
 
 // for testing this flag is set to a lower value, so it has to be checked, if already set
+// this is only the default-value for the maximum single-message-size, because the real value is
+// negotiated for each session while the session-handshake
 #ifndef MAX_SINGLE_MESSAGE_SIZE
 #define MAX_SINGLE_MESSAGE_SIZE (128*1024)
 #endif
 
+// limits for the configurable maximum single-message-size. A message is only processed, if it fits
+// completely into the ring-buffer of the socket for incoming data, which has a fixed size and
+// already had to take the 1 MiB error-messages of older versions
+#define MIN_SINGLE_MESSAGE_SIZE 1024
+#define MAX_SINGLE_MESSAGE_SIZE_LIMIT (1024*1024)
+
+// flow-control of multiblock-messages: number of parts, which the sender can send before the first
+// credit-message of the receiver, number of parts, which are confirmed by one credit-message, and
+// time in seconds, which the sender waits for new credits
+#define MULTIBLOCK_INITIAL_CREDITS 16
+#define MULTIBLOCK_CREDIT_BATCH 4
+#define MULTIBLOCK_CREDIT_TIMEOUT 10
+
+// resumable multiblock-messages: time in seconds, which partial messages of a closed session are
+// kept for a resume, and time in seconds, which the sender waits for the list of received parts
+#define MULTIBLOCK_RESUME_GRACE_PERIOD 300
+#define MULTIBLOCK_RESUME_TIMEOUT 10
+
+// default-limits for the memory of incomplete incoming multiblock-messages for each session and
+// for all sessions together in bytes, and time in seconds, after which an incomplete message
+// without new parts is removed
+#define DEFAULT_MAX_SESSION_MULTIBLOCK_MEMORY (1024ul*1024*1024)
+#define DEFAULT_MAX_TOTAL_MULTIBLOCK_MEMORY (4096ul*1024*1024)
+#define DEFAULT_MULTIBLOCK_IDLE_TIMEOUT 60
+
+// number of slots of the table for incoming multiblock-messages of each session, of which at most
+// 3/4 can be used at the same time
+#define MULTIBLOCK_TABLE_SIZE 256
+
+// number of threads for asynchronous sending, where all messages of one session are sent by the
+// same thread in the order of the calls
+#define NUMBER_OF_SEND_THREADS 4
+
+// number of small frames, which can be sent in a row, before a waiting part of a multiblock-message
+// or another big frame gets its turn
+#define MAX_SMALL_FRAMES_IN_ROW 16
+
+// default-time in milliseconds, in which the reply-message of the other side is expected, and
+// interval in milliseconds of the heartbeat-messages
+#define DEFAULT_REPLY_TIMEOUT 2000
+#define HEARTBEAT_INTERVAL 1000
+
 enum types
 {
     UNDEFINED_TYPE = 0,
@@ -65,6 +125,9 @@ enum session_subTypes
 
     SESSION_CLOSE_START_SUBTYPE = 3,
     SESSION_CLOSE_REPLY_SUBTYPE = 4,
+
+    SESSION_INIT_COMPACT_START_SUBTYPE = 5,
+    SESSION_INIT_COMPACT_REPLY_SUBTYPE = 6,
 };
 
 enum heartbeat_subTypes
@@ -78,6 +141,7 @@ enum error_subTypes
     ERROR_FALSE_VERSION_SUBTYPE = 1,
     ERROR_UNKNOWN_SESSION_SUBTYPE = 2,
     ERROR_INVALID_MESSAGE_SUBTYPE = 3,
+    ERROR_MULTIBLOCK_FAILED_SUBTYPE = 4,
 };
 
 enum stream_data_subTypes
@@ -96,6 +160,10 @@ enum multiblock_data_subTypes
 {
     DATA_MULTI_STATIC_SUBTYPE = 1,
     DATA_MULTI_FINISH_SUBTYPE = 2,
+    DATA_MULTI_CREDIT_SUBTYPE = 3,
+    DATA_MULTI_RESUME_SUBTYPE = 4,
+    DATA_MULTI_RESUME_REPLY_SUBTYPE = 5,
+    DATA_MULTI_ABORT_SUBTYPE = 6,
 };
 
 //==================================================================================================
@@ -140,7 +208,7 @@ struct Session_Init_Start_Message
 {
     CommonMessageHeader commonHeader;
     uint32_t clientSessionId = 0;
-    char sessionIdentifier[64000];
+    char sessionIdentifier[MAX_SESSION_IDENTIFIER_SIZE];
     uint32_t sessionIdentifierSize = 0;
     CommonMessageFooter commonEnd;
 
@@ -162,7 +230,7 @@ struct Session_Init_Reply_Message
     CommonMessageHeader commonHeader;
     uint32_t clientSessionId = 0;
     uint32_t completeSessionId = 0;
-    char sessionIdentifier[64000];
+    char sessionIdentifier[MAX_SESSION_IDENTIFIER_SIZE];
     uint32_t sessionIdentifierSize = 0;
     uint8_t padding[4];
     CommonMessageFooter commonEnd;
@@ -177,6 +245,81 @@ struct Session_Init_Reply_Message
 
 } __attribute__((packed));
 
+/**
+ * @brief Session_Init_Compact_Start_Header
+ *
+ * Variable-length version of the Session_Init_Start_Message. The session-identifier follows
+ * directly behind the header as payload (commonHeader.payloadSize), filled up to a multiple of 8
+ * and closed by the CommonMessageFooter. The headerSize-field contains the size of the header as
+ * it was sent by the other side, so newer handshake-versions can append fields to the header
+ * without breaking the parsing of older versions.
+ *
+ * handshake-version 1: header-size = 40
+ * handshake-version 2: header-size = 48 (added capabilities)
+ * handshake-version 3: header-size = 56 (added maximum single-message-size)
+ * handshake-version 4: header-size = 56 (added id of the parent-session in place of the padding)
+ * handshake-version 5: header-size = 64 (added attach-token of the parent-session)
+ */
+struct Session_Init_Compact_Start_Header
+{
+    CommonMessageHeader commonHeader;
+    uint32_t clientSessionId = 0;
+    uint16_t handshakeVersion = HANDSHAKE_VERSION;
+    uint16_t headerSize = sizeof(Session_Init_Compact_Start_Header);
+    // since handshake-version 2
+    uint64_t capabilities = 0;
+    // since handshake-version 3
+    uint32_t maxSingleSize = 0;
+    // since handshake-version 4
+    uint32_t parentSessionId = 0;
+    // since handshake-version 5
+    uint64_t attachToken = 0;
+
+    Session_Init_Compact_Start_Header()
+    {
+        commonHeader.type = SESSION_TYPE;
+        commonHeader.subType = SESSION_INIT_COMPACT_START_SUBTYPE;
+        commonHeader.flags = 0x1;
+    }
+
+} __attribute__((packed));
+
+/**
+ * @brief Session_Init_Compact_Reply_Header
+ *
+ * Variable-length version of the Session_Init_Reply_Message with the same layout-rules like the
+ * Session_Init_Compact_Start_Header.
+ *
+ * handshake-version 1: header-size = 48
+ * handshake-version 2: header-size = 56 (added capabilities)
+ * handshake-version 3: header-size = 64 (added maximum single-message-size)
+ * handshake-version 5: header-size = 72 (added attach-token for additional connections)
+ */
+struct Session_Init_Compact_Reply_Header
+{
+    CommonMessageHeader commonHeader;
+    uint32_t clientSessionId = 0;
+    uint32_t completeSessionId = 0;
+    uint16_t handshakeVersion = HANDSHAKE_VERSION;
+    uint16_t headerSize = sizeof(Session_Init_Compact_Reply_Header);
+    uint8_t padding[4];
+    // since handshake-version 2
+    uint64_t capabilities = 0;
+    // since handshake-version 3
+    uint32_t maxSingleSize = 0;
+    uint8_t padding2[4];
+    // since handshake-version 5
+    uint64_t attachToken = 0;
+
+    Session_Init_Compact_Reply_Header()
+    {
+        commonHeader.type = SESSION_TYPE;
+        commonHeader.subType = SESSION_INIT_COMPACT_REPLY_SUBTYPE;
+        commonHeader.flags = 0x2;
+    }
+
+} __attribute__((packed));
+
 //==================================================================================================
 
 /**
@@ -259,59 +402,23 @@ struct Heartbeat_Reply_Message
 //==================================================================================================
 
 /**
- * @brief Error_FalseVersion_Message
- */
-struct Error_FalseVersion_Message
-{
-    CommonMessageHeader commonHeader;
-    uint64_t messageSize = 0;
-    char message[MESSAGE_CACHE_SIZE];
-    CommonMessageFooter commonEnd;
-
-    Error_FalseVersion_Message()
-    {
-        commonHeader.type = ERROR_TYPE;
-        commonHeader.subType = ERROR_FALSE_VERSION_SUBTYPE;
-        commonHeader.totalMessageSize = sizeof(Error_FalseVersion_Message);
-    }
-
-} __attribute__((packed));
-
-/**
- * @brief Error_UnknownSession_Message
- */
-struct Error_UnknownSession_Message
-{
-    CommonMessageHeader commonHeader;
-    uint64_t messageSize = 0;
-    char message[MESSAGE_CACHE_SIZE];
-    CommonMessageFooter commonEnd;
-
-    Error_UnknownSession_Message()
-    {
-        commonHeader.type = ERROR_TYPE;
-        commonHeader.subType = ERROR_UNKNOWN_SESSION_SUBTYPE;
-        commonHeader.totalMessageSize = sizeof(Error_UnknownSession_Message);
-    }
-
-} __attribute__((packed));
-
-
-/**
- * @brief Error_InvalidMessage_Message
+ * @brief Error_Message_Header
+ *
+ * Header for all messages of error-type. The human readable error-message follows directly
+ * behind the header as payload, filled up to a multiple of 8 and closed by the
+ * CommonMessageFooter. The layout of the beginning is the same like the old fixed-size
+ * error-messages, so older peers can still read the message.
+ *
+ * header-size = 40
  */
-struct Error_InvalidMessage_Message
+struct Error_Message_Header
 {
     CommonMessageHeader commonHeader;
     uint64_t messageSize = 0;
-    char message[MESSAGE_CACHE_SIZE];
-    CommonMessageFooter commonEnd;
 
-    Error_InvalidMessage_Message()
+    Error_Message_Header()
     {
         commonHeader.type = ERROR_TYPE;
-        commonHeader.subType = ERROR_INVALID_MESSAGE_SUBTYPE;
-        commonHeader.totalMessageSize = sizeof(Error_InvalidMessage_Message);
     }
 
 } __attribute__((packed));
@@ -430,6 +537,103 @@ struct Data_MultiFinish_Message
 
 } __attribute__((packed));
 
+/**
+ * @brief Data_MultiCredit_Message
+ */
+struct Data_MultiCredit_Message
+{
+    CommonMessageHeader commonHeader;
+    uint64_t multiblockId = 0;
+    uint32_t credits = 0;
+    uint8_t padding[4];
+    CommonMessageFooter commonEnd;
+
+    Data_MultiCredit_Message()
+    {
+        commonHeader.type = MULTIBLOCK_DATA_TYPE;
+        commonHeader.subType = DATA_MULTI_CREDIT_SUBTYPE;
+        commonHeader.totalMessageSize = sizeof(Data_MultiCredit_Message);
+    }
+
+} __attribute__((packed));
+
+/**
+ * @brief Data_MultiAbort_Message
+ */
+struct Data_MultiAbort_Message
+{
+    CommonMessageHeader commonHeader;
+    uint64_t multiblockId = 0;
+    CommonMessageFooter commonEnd;
+
+    Data_MultiAbort_Message()
+    {
+        commonHeader.type = MULTIBLOCK_DATA_TYPE;
+        commonHeader.subType = DATA_MULTI_ABORT_SUBTYPE;
+        commonHeader.totalMessageSize = sizeof(Data_MultiAbort_Message);
+    }
+
+} __attribute__((packed));
+
+/**
+ * @brief Data_MultiResume_Message
+ */
+struct Data_MultiResume_Message
+{
+    CommonMessageHeader commonHeader;
+    uint64_t multiblockId = 0;
+    uint64_t totalSize = 0;
+    uint32_t totalPartNumber = 0;
+    uint8_t padding[4];
+    CommonMessageFooter commonEnd;
+
+    Data_MultiResume_Message()
+    {
+        commonHeader.type = MULTIBLOCK_DATA_TYPE;
+        commonHeader.subType = DATA_MULTI_RESUME_SUBTYPE;
+        commonHeader.totalMessageSize = sizeof(Data_MultiResume_Message);
+    }
+
+} __attribute__((packed));
+
+/**
+ * @brief Data_MultiResumeReply_Header
+ *
+ * payload: bitmap with one bit for each received part as list of uint64_t
+ */
+struct Data_MultiResumeReply_Header
+{
+    CommonMessageHeader commonHeader;
+    uint64_t multiblockId = 0;
+
+    Data_MultiResumeReply_Header()
+    {
+        commonHeader.type = MULTIBLOCK_DATA_TYPE;
+        commonHeader.subType = DATA_MULTI_RESUME_REPLY_SUBTYPE;
+    }
+
+} __attribute__((packed));
+
+//==================================================================================================
+
+/**
+ * @brief calculate the size of a complete variable-length message
+ *
+ * @param headerSize size of the header of the message
+ * @param payloadSize number of bytes of the payload
+ *
+ * @return size of header + payload + padding to a multiple of 8 + footer
+ */
+inline uint32_t
+calcMessageSize(const uint64_t headerSize,
+                const uint64_t payloadSize)
+{
+    return static_cast<uint32_t>(headerSize
+                                 + payloadSize
+                                 + (8 - (payloadSize % 8)) % 8  // fill up to a multiple of 8
+                                 + sizeof(CommonMessageFooter));
+}
+
 //==================================================================================================
 
 } // namespace Sakura
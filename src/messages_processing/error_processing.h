@@ -57,75 +57,68 @@ send_ErrorMessage(Session* session,
 {
     LOG_DEBUG("SEND error message");
 
+    Error_Message_Header header;
+
+    // convert error-code into message-subtype
     switch(errorCode)
     {
-        //------------------------------------------------------------------------------------------
         case Session::errorCodes::FALSE_VERSION:
-        {
-            Error_FalseVersion_Message message;
-
-            // fill message
-            message.commonHeader.sessionId = session->sessionId();
-            message.commonHeader.messageId = session->increaseMessageIdCounter();
-            message.messageSize = errorMessage.size();
-
-            // check and copy message-content
-            if(message.messageSize > MAX_SINGLE_MESSAGE_SIZE - 1) {
-                message.messageSize = MAX_SINGLE_MESSAGE_SIZE - 1;
-            }
-            strncpy(message.message, errorMessage.c_str(),  message.messageSize);
-
-            // send
-            return session->sendMessage(message, error);
-        }
-        //------------------------------------------------------------------------------------------
+            header.commonHeader.subType = ERROR_FALSE_VERSION_SUBTYPE;
+            break;
         case Session::errorCodes::UNKNOWN_SESSION:
-        {
-            Error_UnknownSession_Message message;
-
-            // fill message
-            message.commonHeader.sessionId = session->sessionId();
-            message.commonHeader.messageId = session->increaseMessageIdCounter();
-            message.messageSize = errorMessage.size();
-
-            // check and copy message-content
-            if(message.messageSize > MAX_SINGLE_MESSAGE_SIZE - 1) {
-                message.messageSize = MAX_SINGLE_MESSAGE_SIZE - 1;
-            }
-            strncpy(message.message,
-                    errorMessage.c_str(),
-                    message.messageSize);
-
-            // send
-            return session->sendMessage(message, error);
-        }
-        //------------------------------------------------------------------------------------------
+            header.commonHeader.subType = ERROR_UNKNOWN_SESSION_SUBTYPE;
+            break;
         case Session::errorCodes::INVALID_MESSAGE_SIZE:
-        {
-            Error_InvalidMessage_Message message;
+            header.commonHeader.subType = ERROR_INVALID_MESSAGE_SUBTYPE;
+            break;
+        case Session::errorCodes::MULTIBLOCK_FAILED:
+            header.commonHeader.subType = ERROR_MULTIBLOCK_FAILED_SUBTYPE;
+            break;
+        default:
+            return true;
+    }
 
-            // fill message
-            message.commonHeader.sessionId = session->sessionId();
-            message.commonHeader.messageId = session->increaseMessageIdCounter();
-            message.messageSize = errorMessage.size();
+    // check message-content
+    uint64_t messageSize = errorMessage.size();
+    if(messageSize > MAX_ERROR_MESSAGE_SIZE) {
+        messageSize = MAX_ERROR_MESSAGE_SIZE;
+    }
 
-            // check and copy message-content
-            if(message.messageSize > MAX_SINGLE_MESSAGE_SIZE - 1) {
-                message.messageSize = MAX_SINGLE_MESSAGE_SIZE - 1;
-            }
-            strncpy(message.message,
-                    errorMessage.c_str(),
-                    message.messageSize);
+    // fill message
+    header.commonHeader.sessionId = session->sessionId();
+    header.commonHeader.messageId = session->increaseMessageIdCounter();
+    header.commonHeader.totalMessageSize = calcMessageSize(sizeof(header), messageSize);
+    header.commonHeader.payloadSize = static_cast<uint32_t>(messageSize);
+    header.messageSize = messageSize;
 
-            // send
-            return session->sendMessage(message, error);
-        }
-        //------------------------------------------------------------------------------------------
-        default:
-            break;
+    // send
+    return session->sendFrame(header, errorMessage.c_str(), messageSize, error);
+}
+
+/**
+ * @brief get the human readable error-message out of an incoming error-message
+ *
+ * @param message pointer to the complete message within the message-ring-buffer
+ *
+ * @return error-message, which is empty in case the sizes within the message are invalid
+ */
+inline const std::string
+getErrorMessage(const Error_Message_Header* message)
+{
+    const uint64_t messageSize = message->messageSize;
+    const uint64_t requiredSize = sizeof(Error_Message_Header)
+                                  + messageSize
+                                  + sizeof(CommonMessageFooter);
+
+    // check that the error-message fits into the message
+    if(messageSize > MAX_ERROR_MESSAGE_SIZE
+            || requiredSize > message->commonHeader.totalMessageSize)
+    {
+        return "";
     }
 
-    return true;
+    const char* payload = reinterpret_cast<const char*>(message) + sizeof(Error_Message_Header);
+    return std::string(payload, messageSize);
 }
 
 /**
@@ -144,36 +137,40 @@ process_Error_Type(Session* session,
     // lock is not release, it blocks for eterity.
     session->m_initState = -1;
 
+    const Error_Message_Header* message = static_cast<const Error_Message_Header*>(rawMessage);
+
     switch(header->subType)
     {
         //------------------------------------------------------------------------------------------
         case ERROR_FALSE_VERSION_SUBTYPE:
             {
-                const Error_FalseVersion_Message* message =
-                    static_cast<const Error_FalseVersion_Message*>(rawMessage);
                 session->m_processError(session,
                                         Session::errorCodes::FALSE_VERSION,
-                                        std::string(message->message, message->messageSize));
+                                        getErrorMessage(message));
                 break;
             }
         //------------------------------------------------------------------------------------------
         case ERROR_UNKNOWN_SESSION_SUBTYPE:
             {
-                const Error_UnknownSession_Message* message =
-                    static_cast<const Error_UnknownSession_Message*>(rawMessage);
                 session->m_processError(session,
                                         Session::errorCodes::UNKNOWN_SESSION,
-                                        std::string(message->message, message->messageSize));
+                                        getErrorMessage(message));
                 break;
             }
         //------------------------------------------------------------------------------------------
         case ERROR_INVALID_MESSAGE_SUBTYPE:
             {
-                const Error_InvalidMessage_Message* message =
-                    static_cast<const Error_InvalidMessage_Message*>(rawMessage);
                 session->m_processError(session,
                                         Session::errorCodes::INVALID_MESSAGE_SIZE,
-                                        std::string(message->message, message->messageSize));
+                                        getErrorMessage(message));
+                break;
+            }
+        //------------------------------------------------------------------------------------------
+        case ERROR_MULTIBLOCK_FAILED_SUBTYPE:
+            {
+                session->m_processError(session,
+                                        Session::errorCodes::MULTIBLOCK_FAILED,
+                                        getErrorMessage(message));
                 break;
             }
         //------------------------------------------------------------------------------------------
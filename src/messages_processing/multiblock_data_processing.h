@@ -54,21 +54,12 @@ send_Data_Multi_Static(Session* session,
                        ErrorContainer &error,
                        const uint64_t blockerId = 0)
 {
-    uint8_t messageBuffer[MESSAGE_CACHE_SIZE];
-
-    // bring message-size to a multiple of 8
-    const uint32_t totalMessageSize = sizeof(Data_MultiBlock_Header)
-                                      + size
-                                      + (8 - (size % 8)) % 8  // fill up to a multiple of 8
-                                      + sizeof(CommonMessageFooter);
-
-    CommonMessageFooter end;
     Data_MultiBlock_Header header;
 
     // fill message
     header.commonHeader.sessionId = session->sessionId();
     header.commonHeader.messageId = session->increaseMessageIdCounter();
-    header.commonHeader.totalMessageSize = totalMessageSize;
+    header.commonHeader.totalMessageSize = calcMessageSize(sizeof(Data_MultiBlock_Header), size);
     header.commonHeader.payloadSize = size;
     header.multiblockId = multiblockId;
     header.totalPartNumber = totalPartNumber;
@@ -80,14 +71,7 @@ send_Data_Multi_Static(Session* session,
         header.commonHeader.flags |= 0x8;
     }
 
-    // fill buffer to build the complete message
-    memcpy(&messageBuffer[0], &header, sizeof(Data_MultiBlock_Header));
-    memcpy(&messageBuffer[sizeof(Data_MultiBlock_Header)], data, size);
-    memcpy(&messageBuffer[(totalMessageSize - sizeof(CommonMessageFooter))],
-           &end,
-           sizeof(CommonMessageFooter));
-
-    return session->sendMessage(header.commonHeader, &messageBuffer, totalMessageSize, error);
+    return session->sendFrame(header, data, size, error);
 }
 
 /**
@@ -112,6 +96,151 @@ send_Data_Multi_Finish(Session* session,
     return session->sendMessage(message, error);
 }
 
+/**
+ * @brief send_Data_Multi_Credit
+ */
+inline bool
+send_Data_Multi_Credit(Session* session,
+                       const uint64_t multiblockId,
+                       const uint32_t credits,
+                       ErrorContainer &error)
+{
+    Data_MultiCredit_Message message;
+
+    message.commonHeader.sessionId = session->sessionId();
+    message.commonHeader.messageId = session->increaseMessageIdCounter();
+    message.multiblockId = multiblockId;
+    message.credits = credits;
+
+    return session->sendMessage(message, error);
+}
+
+/**
+ * @brief send_Data_Multi_Abort
+ */
+inline bool
+send_Data_Multi_Abort(Session* session,
+                      const uint64_t multiblockId,
+                      ErrorContainer &error)
+{
+    Data_MultiAbort_Message message;
+
+    message.commonHeader.sessionId = session->sessionId();
+    message.commonHeader.messageId = session->increaseMessageIdCounter();
+    message.multiblockId = multiblockId;
+
+    return session->sendMessage(message, error);
+}
+
+/**
+ * @brief send_Data_Multi_Resume
+ */
+inline bool
+send_Data_Multi_Resume(Session* session,
+                       const uint64_t multiblockId,
+                       const uint64_t totalSize,
+                       const uint32_t totalPartNumber,
+                       ErrorContainer &error)
+{
+    Data_MultiResume_Message message;
+
+    message.commonHeader.sessionId = session->sessionId();
+    message.commonHeader.messageId = session->increaseMessageIdCounter();
+    message.multiblockId = multiblockId;
+    message.totalSize = totalSize;
+    message.totalPartNumber = totalPartNumber;
+
+    return session->sendMessage(message, error);
+}
+
+/**
+ * @brief send_Data_Multi_ResumeReply
+ */
+inline bool
+send_Data_Multi_ResumeReply(Session* session,
+                            const uint64_t multiblockId,
+                            const std::vector<uint64_t> &receivedBitmap,
+                            ErrorContainer &error)
+{
+    Data_MultiResumeReply_Header header;
+    const uint32_t size = static_cast<uint32_t>(receivedBitmap.size() * sizeof(uint64_t));
+
+    header.commonHeader.sessionId = session->sessionId();
+    header.commonHeader.messageId = session->increaseMessageIdCounter();
+    header.commonHeader.totalMessageSize = calcMessageSize(sizeof(Data_MultiResumeReply_Header),
+                                                           size);
+    header.commonHeader.payloadSize = size;
+    header.multiblockId = multiblockId;
+
+    return session->sendFrame(header, receivedBitmap.data(), size, error);
+}
+
+/**
+ * @brief get the session, which handles the multiblock-messages of a connection
+ *
+ * @param session session of the connection, where the message was received
+ *
+ * @return parent-session, if the session is an additional connection, else the session itself
+ */
+inline Session*
+getMultiblockSession(Session* session)
+{
+    if(session->m_parentSession != nullptr) {
+        return session->m_parentSession;
+    }
+
+    return session;
+}
+
+/**
+ * @brief give a complete multiblock-message to the blocked requester or to the callback
+ *
+ * @param session session, which had received the message
+ * @param buffer complete multiblock-message
+ */
+inline void
+finish_Data_Multiblock(Session* session,
+                       MultiblockIO::MultiblockBuffer &buffer)
+{
+    // all parts of streamed messages were already given to the part-callback
+    if(buffer.isStreamed) {
+        return;
+    }
+
+    // check if normal standalone-message or if message is response
+    if(buffer.isResponse)
+    {
+        // release thread, which is related to the blocker-id
+        if(SessionHandler::m_blockerHandler->releaseMessage(buffer.blockerId,
+                                                            buffer.incomingData) == false
+                && buffer.isExternal == false)
+        {
+            SessionHandler::m_sessionHandler->releaseBuffer(buffer.incomingData);
+        }
+    }
+    else if(session->m_processRequestView != nullptr)
+    {
+        // trigger callback with a view on the reassembled buffer, which is deleted afterwards,
+        // if it is not owned by the application
+        session->m_processRequestView(session->m_requestViewReceiver,
+                                      session,
+                                      buffer.multiblockId,
+                                      buffer.incomingData->data,
+                                      buffer.incomingData->usedBufferSize);
+        if(buffer.isExternal == false) {
+            SessionHandler::m_sessionHandler->releaseBuffer(buffer.incomingData);
+        }
+    }
+    else
+    {
+        // trigger callback
+        session->m_processRequestData(session->m_standaloneReceiver,
+                                      session,
+                                      buffer.multiblockId,
+                                      buffer.incomingData);
+    }
+}
+
 /**
  * @brief process_Data_Multi_Static
  */
@@ -120,20 +249,54 @@ process_Data_Multiblock(Session* session,
                         const Data_MultiBlock_Header* message,
                         const void* rawMessage)
 {
-    if(message->partId == 0)
+    const uint64_t payloadSize = message->commonHeader.payloadSize;
+    const uint64_t requiredSize = sizeof(Data_MultiBlock_Header)
+                                  + payloadSize
+                                  + sizeof(CommonMessageFooter);
+
+    // check that the part fits into the message, so nothing behind the message is read
+    if(requiredSize > message->commonHeader.totalMessageSize)
     {
-        const bool ret = session->m_multiblockIo->createIncomingBuffer(message->multiblockId,
-                                                                       message->totalSize);
-        if(ret) {
-            // TODO: send error
-        }
+        LOG_WARNING("invalid part of multiblock-message: " + std::to_string(message->multiblockId));
+        return;
+    }
+
+    // parts, which are received over an additional connection, belong to the parent-session
+    Session* target = getMultiblockSession(session);
+
+    if(target->m_multiblockIo->createIncomingBuffer(message->multiblockId,
+                                                    message->totalSize,
+                                                    message->totalPartNumber,
+                                                    target->getMultiblockPartSize(),
+                                                    message->commonHeader.flags & 0x8) == false)
+    {
+        return;
     }
 
     const uint8_t* payloadData = static_cast<const uint8_t*>(rawMessage)
                                  + sizeof(Data_MultiBlock_Header);
-    session->m_multiblockIo->writeIntoIncomingBuffer(message->multiblockId,
-                                                     payloadData,
-                                                     message->commonHeader.payloadSize);
+    uint32_t newCredits = 0;
+    MultiblockIO::MultiblockBuffer completeBuffer;
+    const bool complete =
+            target->m_multiblockIo->writeIntoIncomingBuffer(message->multiblockId,
+                                                            message->partId,
+                                                            payloadData,
+                                                            payloadSize,
+                                                            newCredits,
+                                                            completeBuffer);
+
+    // give processed parts back to the sender as credits for new parts over the same connection
+    if(newCredits > 0
+            && session->hasCapability(Session::MULTIBLOCK_CREDITS))
+    {
+        send_Data_Multi_Credit(session, message->multiblockId, newCredits, session->sessionError);
+    }
+
+    // the finish-message can arrive before the last part, if the parts are sent over multiple
+    // connections
+    if(complete) {
+        finish_Data_Multiblock(target, completeBuffer);
+    }
 }
 
 /**
@@ -143,25 +306,100 @@ inline void
 process_Data_Multi_Finish(Session* session,
                           const Data_MultiFinish_Message* message)
 {
-    MultiblockIO::MultiblockBuffer buffer =
-            session->m_multiblockIo->getIncomingBuffer(message->multiblockId);
+    Session* target = getMultiblockSession(session);
 
-    // check if normal standalone-message or if message is response
-    if(message->commonHeader.flags & 0x8)
+    MultiblockIO::MultiblockBuffer completeBuffer;
+    const bool isResponse = message->commonHeader.flags & 0x8;
+    if(target->m_multiblockIo->finishIncomingBuffer(message->multiblockId,
+                                                    message->blockerId,
+                                                    isResponse,
+                                                    completeBuffer))
     {
-        // release thread, which is related to the blocker-id
-        SessionHandler::m_blockerHandler->releaseMessage(message->blockerId, buffer.incomingData);
+        finish_Data_Multiblock(target, completeBuffer);
     }
-    else
+}
+
+/**
+ * @brief process_Data_Multi_Credit
+ */
+inline void
+process_Data_Multi_Credit(Session* session,
+                          const Data_MultiCredit_Message* message)
+{
+    getMultiblockSession(session)->m_multiblockIo->addCredits(message->multiblockId,
+                                                              message->credits);
+}
+
+/**
+ * @brief process_Data_Multi_Abort
+ */
+inline void
+process_Data_Multi_Abort(Session* session,
+                         const Data_MultiAbort_Message* message)
+{
+    Session* target = getMultiblockSession(session);
+
+    // the other side has rejected an outgoing message of this side
+    target->m_multiblockIo->abortOutgoingData(message->multiblockId);
+
+    if(target->m_multiblockIo->abortIncomingBuffer(message->multiblockId))
     {
-        // trigger callback
-        session->m_processRequestData(session->m_standaloneReceiver,
-                                      session,
-                                      message->multiblockId,
-                                      buffer.incomingData);
+        // the application has to know this for streamed messages and for its own buffers
+        const std::string err = "multiblock-message was aborted by the other side: "
+                                + std::to_string(message->multiblockId);
+        target->m_processError(target, Session::errorCodes::MULTIBLOCK_FAILED, err);
     }
+}
+
+/**
+ * @brief process_Data_Multi_Resume
+ */
+inline void
+process_Data_Multi_Resume(Session* session,
+                          const Data_MultiResume_Message* message)
+{
+    Session* target = getMultiblockSession(session);
+
+    std::vector<uint64_t> receivedBitmap;
+    target->m_multiblockIo->resumeIncomingBuffer(message->multiblockId,
+                                                 message->totalSize,
+                                                 message->totalPartNumber,
+                                                 target->getMultiblockPartSize(),
+                                                 receivedBitmap);
 
-    session->m_multiblockIo->removeMultiblockBuffer(message->multiblockId);
+    send_Data_Multi_ResumeReply(session,
+                                message->multiblockId,
+                                receivedBitmap,
+                                session->sessionError);
+}
+
+/**
+ * @brief process_Data_Multi_ResumeReply
+ */
+inline void
+process_Data_Multi_ResumeReply(Session* session,
+                               const Data_MultiResumeReply_Header* message,
+                               const void* rawMessage)
+{
+    const uint64_t payloadSize = message->commonHeader.payloadSize;
+    const uint64_t requiredSize = sizeof(Data_MultiResumeReply_Header)
+                                  + payloadSize
+                                  + sizeof(CommonMessageFooter);
+
+    // check that the bitmap fits into the message
+    if(requiredSize > message->commonHeader.totalMessageSize)
+    {
+        LOG_WARNING("invalid resume-reply of multiblock-message");
+        return;
+    }
+
+    const uint64_t* receivedBitmap = reinterpret_cast<const uint64_t*>(
+                static_cast<const uint8_t*>(rawMessage) + sizeof(Data_MultiResumeReply_Header));
+    const uint64_t numberOfBlocks = payloadSize / sizeof(uint64_t);
+
+    getMultiblockSession(session)->m_multiblockIo->setReceivedParts(message->multiblockId,
+                                                                    receivedBitmap,
+                                                                    numberOfBlocks);
 }
 
 /**
@@ -195,6 +433,38 @@ process_MultiBlock_Data_Type(Session* session,
                 break;
             }
         //------------------------------------------------------------------------------------------
+        case DATA_MULTI_CREDIT_SUBTYPE:
+            {
+                const Data_MultiCredit_Message* message =
+                    static_cast<const Data_MultiCredit_Message*>(rawMessage);
+                process_Data_Multi_Credit(session, message);
+                break;
+            }
+        //------------------------------------------------------------------------------------------
+        case DATA_MULTI_ABORT_SUBTYPE:
+            {
+                const Data_MultiAbort_Message* message =
+                    static_cast<const Data_MultiAbort_Message*>(rawMessage);
+                process_Data_Multi_Abort(session, message);
+                break;
+            }
+        //------------------------------------------------------------------------------------------
+        case DATA_MULTI_RESUME_SUBTYPE:
+            {
+                const Data_MultiResume_Message* message =
+                    static_cast<const Data_MultiResume_Message*>(rawMessage);
+                process_Data_Multi_Resume(session, message);
+                break;
+            }
+        //------------------------------------------------------------------------------------------
+        case DATA_MULTI_RESUME_REPLY_SUBTYPE:
+            {
+                const Data_MultiResumeReply_Header* message =
+                    static_cast<const Data_MultiResumeReply_Header*>(rawMessage);
+                process_Data_Multi_ResumeReply(session, message, rawMessage);
+                break;
+            }
+        //------------------------------------------------------------------------------------------
         default:
             break;
     }
@@ -23,9 +23,15 @@
 #ifndef KITSUNEMIMI_SAKURA_NETWORK_SESSION_PROCESSING_H
 #define KITSUNEMIMI_SAKURA_NETWORK_SESSION_PROCESSING_H
 
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <random>
+
 #include <message_definitions.h>
 #include <handler/session_handler.h>
 #include <multiblock_io.h>
+#include <buffer_pool.h>
 
 #include <libKitsunemimiNetwork/abstract_socket.h>
 
@@ -40,40 +46,177 @@ namespace Sakura
 {
 
 /**
- * @brief send_Session_Init_Start
+ * @brief send_Session_Init_Legacy_Start
+ *
+ * @param session pointer to the session
+ * @param sessionIdentifier custom value, which is sended within the init-message to pre-identify
+ */
+inline bool
+send_Session_Init_Legacy_Start(Session* session,
+                               const std::string &sessionIdentifier,
+                               ErrorContainer &error)
+{
+    LOG_DEBUG("SEND session init start (legacy)");
+
+    // the message is too big for the stack, so it is build within a buffer of the frame-pool
+    DataBuffer* buffer = session->m_framePool->allocateBuffer(sizeof(Session_Init_Start_Message));
+    if(buffer->data == nullptr)
+    {
+        session->m_framePool->releaseBuffer(buffer);
+        return false;
+    }
+    Session_Init_Start_Message* message = new(buffer->data) Session_Init_Start_Message();
+
+    message->commonHeader.sessionId = session->sessionId();
+    message->commonHeader.messageId = session->increaseMessageIdCounter();
+    message->clientSessionId = session->sessionId();
+
+    message->sessionIdentifierSize = static_cast<uint32_t>(sessionIdentifier.size());
+    memcpy(message->sessionIdentifier, sessionIdentifier.c_str(), sessionIdentifier.size());
+
+    const bool ret = session->sendMessage(*message, error);
+    session->m_framePool->releaseBuffer(buffer);
+
+    return ret;
+}
+
+/**
+ * @brief send_Session_Init_Compact_Start
+ *
+ * @param session pointer to the session
+ * @param sessionIdentifier custom value, which is sended within the init-message to pre-identify
+ */
+inline bool
+send_Session_Init_Compact_Start(Session* session,
+                                const std::string &sessionIdentifier,
+                                ErrorContainer &error)
+{
+    LOG_DEBUG("SEND session init start");
+
+    Session_Init_Compact_Start_Header header;
+    const uint32_t size = static_cast<uint32_t>(sessionIdentifier.size());
+
+    header.commonHeader.sessionId = session->sessionId();
+    header.commonHeader.messageId = session->increaseMessageIdCounter();
+    header.commonHeader.totalMessageSize = calcMessageSize(sizeof(header), size);
+    header.commonHeader.payloadSize = size;
+    header.clientSessionId = session->sessionId();
+    header.capabilities = session->m_localCapabilities;
+    header.maxSingleSize = session->m_localMaxSingleSize;
+    if(session->m_parentSession != nullptr)
+    {
+        header.parentSessionId = session->m_parentSession->sessionId();
+        header.attachToken = session->m_parentSession->m_attachToken;
+    }
+
+    return session->sendFrame(header, sessionIdentifier.c_str(), size, error);
+}
+
+/**
+ * @brief send the initial message of the session-handshake. The compact message-version is used
+ *        as long as it is not known, that the other side only supports the old fixed-size version.
  *
  * @param session pointer to the session
  * @param sessionIdentifier custom value, which is sended within the init-message to pre-identify
- *                          the message on server-side
  */
 inline bool
 send_Session_Init_Start(Session* session,
                         const std::string &sessionIdentifier,
                         ErrorContainer &error)
 {
-    LOG_DEBUG("SEND session init start");
+    if(session->m_legacyHandshake) {
+        return send_Session_Init_Legacy_Start(session, sessionIdentifier, error);
+    }
 
-    Session_Init_Start_Message message;
+    return send_Session_Init_Compact_Start(session, sessionIdentifier, error);
+}
 
-    message.commonHeader.sessionId = session->sessionId();
-    message.commonHeader.messageId = session->increaseMessageIdCounter();
-    message.clientSessionId = session->sessionId();
+/**
+ * @brief send_Session_Init_Legacy_Reply
+ *
+ * @param session pointer to the session
+ * @param initialSessionId initial id, which was sended by the client
+ * @param messageId id of the original incoming message
+ * @param completeSessionId completed session-id based on the id of the server and the client
+ * @param sessionIdentifier custom value, which is sended within the init-message to pre-identify
+ */
+inline bool
+send_Session_Init_Legacy_Reply(Session* session,
+                               const uint32_t initialSessionId,
+                               const uint32_t messageId,
+                               const uint32_t completeSessionId,
+                               const std::string &sessionIdentifier,
+                               ErrorContainer &error)
+{
+    LOG_DEBUG("SEND session init reply (legacy)");
+
+    // the message is too big for the stack, so it is build within a buffer of the frame-pool
+    DataBuffer* buffer = session->m_framePool->allocateBuffer(sizeof(Session_Init_Reply_Message));
+    if(buffer->data == nullptr)
+    {
+        session->m_framePool->releaseBuffer(buffer);
+        return false;
+    }
+    Session_Init_Reply_Message* message = new(buffer->data) Session_Init_Reply_Message();
 
-    message.sessionIdentifierSize = static_cast<uint32_t>(sessionIdentifier.size());
-    memcpy(message.sessionIdentifier, sessionIdentifier.c_str(), sessionIdentifier.size());
+    message->commonHeader.sessionId = initialSessionId;
+    message->commonHeader.messageId = messageId;
+    message->completeSessionId = completeSessionId;
+    message->clientSessionId = initialSessionId;
 
-    return session->sendMessage(message, error);
+    message->sessionIdentifierSize = static_cast<uint32_t>(sessionIdentifier.size());
+    memcpy(message->sessionIdentifier, sessionIdentifier.c_str(), sessionIdentifier.size());
+
+    const bool ret = session->sendMessage(*message, error);
+    session->m_framePool->releaseBuffer(buffer);
+
+    return ret;
+}
+
+/**
+ * @brief send_Session_Init_Compact_Reply
+ *
+ * @param session pointer to the session
+ * @param initialSessionId initial id, which was sended by the client
+ * @param messageId id of the original incoming message
+ * @param completeSessionId completed session-id based on the id of the server and the client
+ * @param sessionIdentifier custom value, which is sended within the init-message to pre-identify
+ */
+inline bool
+send_Session_Init_Compact_Reply(Session* session,
+                                const uint32_t initialSessionId,
+                                const uint32_t messageId,
+                                const uint32_t completeSessionId,
+                                const std::string &sessionIdentifier,
+                                ErrorContainer &error)
+{
+    LOG_DEBUG("SEND session init reply");
+
+    Session_Init_Compact_Reply_Header header;
+    const uint32_t size = static_cast<uint32_t>(sessionIdentifier.size());
+
+    header.commonHeader.sessionId = initialSessionId;
+    header.commonHeader.messageId = messageId;
+    header.commonHeader.totalMessageSize = calcMessageSize(sizeof(header), size);
+    header.commonHeader.payloadSize = size;
+    header.completeSessionId = completeSessionId;
+    header.clientSessionId = initialSessionId;
+    header.capabilities = session->m_capabilities;
+    header.maxSingleSize = session->m_maxSingleSize;
+    header.attachToken = session->m_attachToken;
+
+    return session->sendFrame(header, sessionIdentifier.c_str(), size, error);
 }
 
 /**
- * @brief send_Session_Init_Reply
+ * @brief send the reply-message of the session-handshake in the same message-version, which was
+ *        used by the other side for the init-message
  *
  * @param session pointer to the session
  * @param initialSessionId initial id, which was sended by the client
  * @param messageId id of the original incoming message
  * @param completeSessionId completed session-id based on the id of the server and the client
  * @param sessionIdentifier custom value, which is sended within the init-message to pre-identify
- *                          the message on server-side
  */
 inline bool
 send_Session_Init_Reply(Session* session,
@@ -83,19 +226,22 @@ send_Session_Init_Reply(Session* session,
                         const std::string &sessionIdentifier,
                         ErrorContainer &error)
 {
-    LOG_DEBUG("SEND session init reply");
-
-    Session_Init_Reply_Message message;
-
-    message.commonHeader.sessionId = initialSessionId;
-    message.commonHeader.messageId = messageId;
-    message.completeSessionId = completeSessionId;
-    message.clientSessionId = initialSessionId;
-
-    message.sessionIdentifierSize = static_cast<uint32_t>(sessionIdentifier.size());
-    memcpy(message.sessionIdentifier, sessionIdentifier.c_str(), sessionIdentifier.size());
+    if(session->m_legacyHandshake)
+    {
+        return send_Session_Init_Legacy_Reply(session,
+                                              initialSessionId,
+                                              messageId,
+                                              completeSessionId,
+                                              sessionIdentifier,
+                                              error);
+    }
 
-    return session->sendMessage(message, error);
+    return send_Session_Init_Compact_Reply(session,
+                                           initialSessionId,
+                                           messageId,
+                                           completeSessionId,
+                                           sessionIdentifier,
+                                           error);
 }
 
 /**
@@ -144,22 +290,146 @@ send_Session_Close_Reply(Session* session,
 }
 
 /**
- * @brief process_Session_Init_Start
+ * @brief apply the values of the other side from the session-handshake to the session
  *
  * @param session pointer to the session
- * @param message pointer to the complete message within the message-ring-buffer
+ * @param capabilities capabilities of the other side
+ * @param maxSingleSize maximum single-message-size of the other side
  */
 inline void
-process_Session_Init_Start(Session* session,
-                           const Session_Init_Start_Message* message)
+negotiateSessionSettings(Session* session,
+                         const uint64_t capabilities,
+                         const uint32_t maxSingleSize)
 {
-    LOG_DEBUG("process session init start");
+    // use only the features, which are supported by both sides
+    session->m_capabilities = session->m_localCapabilities & capabilities;
+
+    // use the smaller maximum single-message-size of both sides or the default-value, if the
+    // other side doesn't support the negotiation
+    if(session->hasCapability(Session::capabilities::NEGOTIATED_SINGLE_SIZE)
+            && maxSingleSize >= MIN_SINGLE_MESSAGE_SIZE)
+    {
+        session->m_maxSingleSize = std::min(session->m_localMaxSingleSize, maxSingleSize);
+    }
+    else
+    {
+        session->m_maxSingleSize = std::min(session->m_localMaxSingleSize,
+                                            static_cast<uint32_t>(MAX_SINGLE_MESSAGE_SIZE));
+    }
+}
+
+/**
+ * @brief create a random token, which has to be known by a new connection to attach it to an
+ *        existing session
+ *
+ * @return new token, which is not 0
+ */
+inline uint64_t
+createAttachToken()
+{
+    std::random_device randomDevice;
+    uint64_t token = 0;
+
+    // 0 is the value of sessions without token and should never be allowed
+    while(token == 0)
+    {
+        token = (static_cast<uint64_t>(randomDevice()) << 32)
+                | static_cast<uint64_t>(randomDevice());
+    }
+
+    return token;
+}
+
+/**
+ * @brief search a session, to which a new connection should be attached as additional
+ *        connection. The session-map has to be locked by the caller.
+ *
+ * @param parentSessionId id of the session, which should be extended
+ * @param attachToken attach-token, which was sent by the new connection
+ * @param sessionIdentifier session-identifier, which was sent by the new connection
+ *
+ * @return pointer to the session, or nullptr, if not found or the values doesn't match
+ */
+inline Session*
+getAttachableSession(const uint32_t parentSessionId,
+                     const uint64_t attachToken,
+                     const std::string &sessionIdentifier)
+{
+    std::map<uint32_t, Session*>::iterator it;
+    it = SessionHandler::m_sessionHandler->m_sessions.find(parentSessionId);
+    if(it == SessionHandler::m_sessionHandler->m_sessions.end()) {
+        return nullptr;
+    }
+
+    // only sessions, which were accepted by this side and which are not additional connections
+    // by themselves, can be extended and only by a connection, which knows their token
+    Session* parent = it->second;
+    if(parent->m_parentSession != nullptr
+            || parent->isClientSide()
+            || parent->m_attachToken == 0
+            || parent->m_attachToken != attachToken
+            || parent->m_sessionIdentifier != sessionIdentifier)
+    {
+        return nullptr;
+    }
+
+    return parent;
+}
+
+/**
+ * @brief create the session on server-side and send the reply-message to the client
+ *
+ * @param session pointer to the session
+ * @param clientSessionId initial session-id, which was sended by the client
+ * @param messageId id of the incoming init-message
+ * @param sessionIdentifier custom value, which was sended within the init-message
+ * @param capabilities capabilities, which are supported by the client
+ * @param maxSingleSize maximum single-message-size of the client
+ * @param parentSessionId id of the session, which should be extended by this session as
+ *                        additional connection, or 0 for a normal session
+ * @param attachToken attach-token of the session, which should be extended
+ */
+inline void
+initServerSession(Session* session,
+                  const uint32_t clientSessionId,
+                  const uint32_t messageId,
+                  const std::string &sessionIdentifier,
+                  const uint64_t capabilities,
+                  const uint32_t maxSingleSize,
+                  const uint32_t parentSessionId = 0,
+                  const uint64_t attachToken = 0)
+{
+    negotiateSessionSettings(session, capabilities, maxSingleSize);
+
+    // register session as additional connection of an existing session
+    if(parentSessionId != 0
+            && session->hasCapability(Session::capabilities::MULTIPATH))
+    {
+        SessionHandler::m_sessionHandler->lockSessionMap();
+        session->m_parentSession = getAttachableSession(parentSessionId,
+                                                        attachToken,
+                                                        sessionIdentifier);
+        SessionHandler::m_sessionHandler->unlockSessionMap();
+
+        // show the client, that the session can not be used as additional connection
+        if(session->m_parentSession == nullptr)
+        {
+            LOG_WARNING("refused to attach connection to session "
+                        + std::to_string(parentSessionId));
+            session->m_capabilities &= ~static_cast<uint64_t>(Session::capabilities::MULTIPATH);
+        }
+    }
+
+    // only normal sessions can be extended by additional connections
+    if(session->m_parentSession == nullptr
+            && session->hasCapability(Session::capabilities::MULTIPATH))
+    {
+        session->m_attachToken = createAttachToken();
+    }
 
     // get and calculate session-id
-    const uint32_t clientSessionId = message->clientSessionId;
     const uint16_t serverSessionId = SessionHandler::m_sessionHandler->increaseSessionIdCounter();
     const uint32_t sessionId = clientSessionId + (serverSessionId * 0x10000);
-    const std::string sessionIdentifier(message->sessionIdentifier, message->sessionIdentifierSize);
 
     // create new session and make it ready
     SessionHandler::m_sessionHandler->addSession(sessionId, session);
@@ -169,27 +439,54 @@ process_Session_Init_Start(Session* session,
     // send
     send_Session_Init_Reply(session,
                             clientSessionId,
-                            message->commonHeader.messageId,
+                            messageId,
                             sessionId,
                             sessionIdentifier,
                             session->sessionError);
+
+    if(session->m_parentSession == nullptr) {
+        return;
+    }
+
+    // the parent-session could be closed in the meantime, so it is searched again and the
+    // connection is added, while the session-map is locked, because the parent is removed from
+    // the map, before it deletes its additional connections
+    SessionHandler::m_sessionHandler->lockSessionMap();
+    Session* parent = getAttachableSession(parentSessionId, attachToken, sessionIdentifier);
+    if(parent == session->m_parentSession) {
+        parent->addPath(session);
+    }
+    SessionHandler::m_sessionHandler->unlockSessionMap();
+
+    if(parent != session->m_parentSession)
+    {
+        session->m_parentSession = nullptr;
+        session->closeSession(session->sessionError, false);
+    }
 }
 
 /**
- * @brief process_Session_Init_Reply
+ * @brief finish the session-init on client-side
  *
  * @param session pointer to the session
- * @param message pointer to the complete message within the message-ring-buffer
+ * @param initialId initial session-id of the client
+ * @param completeSessionId final session-id, which was created by the server
+ * @param sessionIdentifier custom value, which was sended within the init-message
+ * @param capabilities capabilities, which were accepted by the server
+ * @param maxSingleSize maximum single-message-size, which was accepted by the server
+ * @param attachToken token to attach additional connections to the session
  */
 inline void
-process_Session_Init_Reply(Session* session,
-                           const Session_Init_Reply_Message* message)
+finishClientSession(Session* session,
+                    const uint32_t initialId,
+                    const uint32_t completeSessionId,
+                    const std::string &sessionIdentifier,
+                    const uint64_t capabilities,
+                    const uint32_t maxSingleSize,
+                    const uint64_t attachToken = 0)
 {
-    LOG_DEBUG("process session init reply");
-
-    const uint32_t completeSessionId = message->completeSessionId;
-    const uint32_t initialId = message->clientSessionId;
-    const std::string sessionIdentifier(message->sessionIdentifier, message->sessionIdentifierSize);
+    negotiateSessionSettings(session, capabilities, maxSingleSize);
+    session->m_attachToken = attachToken;
 
     // readd session under the new complete session-id and make session ready
     SessionHandler::m_sessionHandler->removeSession(initialId);
@@ -198,6 +495,153 @@ process_Session_Init_Reply(Session* session,
     session->makeSessionReady(completeSessionId, sessionIdentifier, session->sessionError);
 }
 
+/**
+ * @brief copy the header of a compact session-init-message into a local object. Fields, which
+ *        are not within the incoming message, because the other side uses an older
+ *        handshake-version, keep their default-values.
+ *
+ * @param target reference to the local header-object
+ * @param message pointer to the complete message within the message-ring-buffer
+ *
+ * @return false, if the sizes within the header are invalid, else true
+ */
+template<typename T>
+inline bool
+readCompactInitHeader(T &target,
+                      const T* message)
+{
+    const uint64_t headerSize = message->headerSize;
+    const uint64_t requiredSize = headerSize
+                                  + message->commonHeader.payloadSize
+                                  + sizeof(CommonMessageFooter);
+
+    // check that header and payload fit into the message
+    if(headerSize < offsetof(T, headerSize) + sizeof(uint16_t)
+            || requiredSize > message->commonHeader.totalMessageSize)
+    {
+        return false;
+    }
+
+    // copy all known fields behind the common header
+    const uint64_t copySize = std::min(headerSize, static_cast<uint64_t>(sizeof(T)))
+                              - sizeof(CommonMessageHeader);
+    memcpy(reinterpret_cast<uint8_t*>(&target) + sizeof(CommonMessageHeader),
+           reinterpret_cast<const uint8_t*>(message) + sizeof(CommonMessageHeader),
+           copySize);
+    target.commonHeader.messageId = message->commonHeader.messageId;
+    target.commonHeader.payloadSize = message->commonHeader.payloadSize;
+
+    return true;
+}
+
+/**
+ * @brief process_Session_Init_Legacy_Start
+ *
+ * @param session pointer to the session
+ * @param message pointer to the complete message within the message-ring-buffer
+ */
+inline void
+process_Session_Init_Legacy_Start(Session* session,
+                                  const Session_Init_Start_Message* message)
+{
+    LOG_DEBUG("process session init start (legacy)");
+
+    const std::string sessionIdentifier(message->sessionIdentifier, message->sessionIdentifierSize);
+
+    // answer the old client in the same message-version
+    session->m_legacyHandshake = true;
+    initServerSession(session,
+                      message->clientSessionId,
+                      message->commonHeader.messageId,
+                      sessionIdentifier,
+                      Session::capabilities::NO_CAPABILITY,
+                      0);
+}
+
+/**
+ * @brief process_Session_Init_Compact_Start
+ *
+ * @param session pointer to the session
+ * @param message pointer to the complete message within the message-ring-buffer
+ */
+inline void
+process_Session_Init_Compact_Start(Session* session,
+                                   const Session_Init_Compact_Start_Header* message)
+{
+    LOG_DEBUG("process session init start");
+
+    Session_Init_Compact_Start_Header header;
+    if(readCompactInitHeader(header, message) == false)
+    {
+        LOG_WARNING("invalid session init start message");
+        return;
+    }
+
+    const char* payload = reinterpret_cast<const char*>(message) + header.headerSize;
+    const std::string sessionIdentifier(payload, header.commonHeader.payloadSize);
+
+    initServerSession(session,
+                      header.clientSessionId,
+                      header.commonHeader.messageId,
+                      sessionIdentifier,
+                      header.capabilities,
+                      header.maxSingleSize,
+                      header.parentSessionId,
+                      header.attachToken);
+}
+
+/**
+ * @brief process_Session_Init_Legacy_Reply
+ *
+ * @param session pointer to the session
+ * @param message pointer to the complete message within the message-ring-buffer
+ */
+inline void
+process_Session_Init_Legacy_Reply(Session* session,
+                                  const Session_Init_Reply_Message* message)
+{
+    LOG_DEBUG("process session init reply (legacy)");
+
+    const std::string sessionIdentifier(message->sessionIdentifier, message->sessionIdentifierSize);
+    finishClientSession(session,
+                        message->clientSessionId,
+                        message->completeSessionId,
+                        sessionIdentifier,
+                        Session::capabilities::NO_CAPABILITY,
+                        0);
+}
+
+/**
+ * @brief process_Session_Init_Compact_Reply
+ *
+ * @param session pointer to the session
+ * @param message pointer to the complete message within the message-ring-buffer
+ */
+inline void
+process_Session_Init_Compact_Reply(Session* session,
+                                   const Session_Init_Compact_Reply_Header* message)
+{
+    LOG_DEBUG("process session init reply");
+
+    Session_Init_Compact_Reply_Header header;
+    if(readCompactInitHeader(header, message) == false)
+    {
+        LOG_WARNING("invalid session init reply message");
+        session->m_initState = -1;
+        return;
+    }
+
+    const char* payload = reinterpret_cast<const char*>(message) + header.headerSize;
+    const std::string sessionIdentifier(payload, header.commonHeader.payloadSize);
+    finishClientSession(session,
+                        header.clientSessionId,
+                        header.completeSessionId,
+                        sessionIdentifier,
+                        header.capabilities,
+                        header.maxSingleSize,
+                        header.attachToken);
+}
+
 /**
  * @brief process_Session_Close_Start
  *
@@ -257,7 +701,7 @@ process_Session_Type(Session* session,
             {
                 const Session_Init_Start_Message* message =
                     static_cast<const Session_Init_Start_Message*>(rawMessage);
-                process_Session_Init_Start(session, message);
+                process_Session_Init_Legacy_Start(session, message);
                 break;
             }
         //------------------------------------------------------------------------------------------
@@ -265,7 +709,23 @@ process_Session_Type(Session* session,
             {
                 const Session_Init_Reply_Message* message =
                     static_cast<const Session_Init_Reply_Message*>(rawMessage);
-                process_Session_Init_Reply(session, message);
+                process_Session_Init_Legacy_Reply(session, message);
+                break;
+            }
+        //------------------------------------------------------------------------------------------
+        case SESSION_INIT_COMPACT_START_SUBTYPE:
+            {
+                const Session_Init_Compact_Start_Header* message =
+                    static_cast<const Session_Init_Compact_Start_Header*>(rawMessage);
+                process_Session_Init_Compact_Start(session, message);
+                break;
+            }
+        //------------------------------------------------------------------------------------------
+        case SESSION_INIT_COMPACT_REPLY_SUBTYPE:
+            {
+                const Session_Init_Compact_Reply_Header* message =
+                    static_cast<const Session_Init_Compact_Reply_Header*>(rawMessage);
+                process_Session_Init_Compact_Reply(session, message);
                 break;
             }
         //------------------------------------------------------------------------------------------
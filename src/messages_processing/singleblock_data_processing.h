@@ -51,21 +51,42 @@ send_Data_SingleBlock(Session* session,
                       ErrorContainer &error,
                       const uint64_t blockerId = 0)
 {
-    uint8_t messageBuffer[MESSAGE_CACHE_SIZE];
+    Data_SingleBlock_Header header;
+
+    // fill message
+    header.commonHeader.sessionId = session->sessionId();
+    header.commonHeader.messageId = session->increaseMessageIdCounter();
+    header.commonHeader.totalMessageSize = calcMessageSize(sizeof(Data_SingleBlock_Header), size);
+    header.commonHeader.payloadSize = size;
+    header.blockerId = blockerId;
+    header.multiblockId = multiblockId;
 
-    // bring message-size to a multiple of 8
-    const uint32_t totalMessageSize = sizeof(Data_SingleBlock_Header)
-                                      + size
-                                      + (8 - (size % 8)) % 8  // fill up to a multiple of 8
-                                      + sizeof(CommonMessageFooter);
+    // set flag to await response-message for blocker-id
+    if(blockerId != 0) {
+        header.commonHeader.flags |= 0x8;
+    }
+
+    // send
+    return session->sendFrame(header, data, size, error);
+}
 
-    CommonMessageFooter end;
+/**
+ * @brief send singleblock-message, which payload is already located within a reserved frame
+ */
+inline bool
+send_Data_SingleBlock_InPlace(Session* session,
+                              const uint64_t multiblockId,
+                              void* data,
+                              uint32_t size,
+                              ErrorContainer &error,
+                              const uint64_t blockerId = 0)
+{
     Data_SingleBlock_Header header;
 
     // fill message
     header.commonHeader.sessionId = session->sessionId();
     header.commonHeader.messageId = session->increaseMessageIdCounter();
-    header.commonHeader.totalMessageSize = totalMessageSize;
+    header.commonHeader.totalMessageSize = calcMessageSize(sizeof(Data_SingleBlock_Header), size);
     header.commonHeader.payloadSize = size;
     header.blockerId = blockerId;
     header.multiblockId = multiblockId;
@@ -75,15 +96,8 @@ send_Data_SingleBlock(Session* session,
         header.commonHeader.flags |= 0x8;
     }
 
-    // fill buffer with all parts of the message
-    memcpy(&messageBuffer[0], &header, sizeof(Data_SingleBlock_Header));
-    memcpy(&messageBuffer[sizeof(Data_SingleBlock_Header)], data, size);
-    memcpy(&messageBuffer[(totalMessageSize - sizeof(CommonMessageFooter))],
-           &end,
-           sizeof(CommonMessageFooter));
-
     // send
-    return session->sendMessage(header.commonHeader, &messageBuffer, totalMessageSize, error);
+    return session->sendFrameInPlace(header, data, size, error);
 }
 
 /**
@@ -110,26 +124,38 @@ process_Data_SingleBlock(Session* session,
                          const Data_SingleBlock_Header* header,
                          const void* rawMessage)
 {
-    // prepare buffer for payload
-    const uint32_t payloadSize = header->commonHeader.payloadSize;
-    DataBuffer* buffer = new DataBuffer(Kitsunemimi::calcBytesToBlocks(payloadSize));
-
     // get pointer to the beginning of the payload
+    const uint32_t payloadSize = header->commonHeader.payloadSize;
     const uint8_t* payloadData = static_cast<const uint8_t*>(rawMessage)
                                  + sizeof(Data_SingleBlock_Header);
 
-    // copy messagy-payload into buffer
-    addData_DataBuffer(*buffer, payloadData, header->commonHeader.payloadSize);
-
     // check if normal standalone-message or if message is response
     if(header->commonHeader.flags & 0x8)
     {
+        // copy messagy-payload into buffer
+        DataBuffer* buffer = SessionHandler::m_sessionHandler->allocateBuffer(payloadSize);
+        addData_DataBuffer(*buffer, payloadData, payloadSize);
+
         // release thread, which is related to the blocker-id
-        SessionHandler::m_blockerHandler->releaseMessage(header->blockerId,
-                                                         buffer);
+        if(SessionHandler::m_blockerHandler->releaseMessage(header->blockerId, buffer) == false) {
+            SessionHandler::m_sessionHandler->releaseBuffer(buffer);
+        }
+    }
+    else if(session->m_processRequestView != nullptr)
+    {
+        // trigger callback with a view on the payload within the message-ring-buffer
+        session->m_processRequestView(session->m_requestViewReceiver,
+                                      session,
+                                      header->multiblockId,
+                                      payloadData,
+                                      payloadSize);
     }
     else
     {
+        // copy messagy-payload into buffer
+        DataBuffer* buffer = SessionHandler::m_sessionHandler->allocateBuffer(payloadSize);
+        addData_DataBuffer(*buffer, payloadData, payloadSize);
+
         // trigger callback
         session->m_processRequestData(session->m_standaloneReceiver,
                                       session,
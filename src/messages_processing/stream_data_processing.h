@@ -45,81 +45,45 @@ namespace Sakura
  */
 inline bool
 send_Data_Stream(Session* session,
-                 DataBuffer* data,
+                 const void* data,
+                 const uint32_t size,
                  const bool replyExpected,
                  ErrorContainer &error)
 {
-    if(data->usedBufferSize < sizeof(CommonMessageFooter) + sizeof(Data_Stream_Header)) {
-        return false;
-    }
-
-    // bring message-size to a multiple of 8
-    const uint32_t size = static_cast<uint32_t>(data->usedBufferSize)
-                                                - sizeof(CommonMessageFooter)
-                                                - sizeof(Data_Stream_Header);
-    const uint32_t totalMessageSize = sizeof(Data_Stream_Header)
-                                      + size
-                                      + (8-(size % 8)) % 8  // fill up to a multiple of 8
-                                      + sizeof(CommonMessageFooter);
-
-    CommonMessageFooter end;
     Data_Stream_Header header;
 
     // fill message
     header.commonHeader.sessionId = session->sessionId();
     header.commonHeader.messageId = session->increaseMessageIdCounter();
-    header.commonHeader.totalMessageSize = totalMessageSize;
+    header.commonHeader.totalMessageSize = calcMessageSize(sizeof(Data_Stream_Header), size);
     header.commonHeader.payloadSize = size;
     header.commonHeader.flags = static_cast<uint8_t>(replyExpected) * 0x1;
 
-    uint8_t* dataPtr = static_cast<uint8_t*>(data->data);
-    // fill buffer to build the complete message
-    memcpy(&dataPtr[0], &header, sizeof(Data_Stream_Header));
-    memcpy(&dataPtr[(totalMessageSize - sizeof(CommonMessageFooter))],
-           &end,
-           sizeof(CommonMessageFooter));
-
     // send
-    return session->sendMessage(header.commonHeader, dataPtr, totalMessageSize, error);
+    return session->sendFrame(header, data, size, error);
 }
 
 /**
- * @brief send_Data_Stream_Static
+ * @brief send stream-message, which payload is already located within a reserved frame
  */
 inline bool
-send_Data_Stream(Session* session,
-                 const void* data,
-                 const uint32_t size,
-                 const bool replyExpected,
-                 ErrorContainer &error)
+send_Data_Stream_InPlace(Session* session,
+                         void* data,
+                         const uint32_t size,
+                         const bool replyExpected,
+                         ErrorContainer &error)
 {
-    uint8_t messageBuffer[MESSAGE_CACHE_SIZE];
-
-    // bring message-size to a multiple of 8
-    const uint32_t totalMessageSize = sizeof(Data_Stream_Header)
-                                      + size
-                                      + (8 - (size % 8)) % 8  // fill up to a multiple of 8
-                                      + sizeof(CommonMessageFooter);
-
-    CommonMessageFooter end;
     Data_Stream_Header header;
 
     // fill message
     header.commonHeader.sessionId = session->sessionId();
     header.commonHeader.messageId = session->increaseMessageIdCounter();
-    header.commonHeader.totalMessageSize = totalMessageSize;
+    header.commonHeader.totalMessageSize = calcMessageSize(sizeof(Data_Stream_Header), size);
     header.commonHeader.payloadSize = size;
     header.commonHeader.flags = static_cast<uint8_t>(replyExpected) * 0x1;
 
-    // fill buffer to build the complete message
-    memcpy(&messageBuffer[0], &header, sizeof(Data_Stream_Header));
-    memcpy(&messageBuffer[sizeof(Data_Stream_Header)], data, size);
-    memcpy(&messageBuffer[(totalMessageSize - sizeof(CommonMessageFooter))],
-           &end,
-           sizeof(CommonMessageFooter));
-
     // send
-    return session->sendMessage(header.commonHeader, messageBuffer, totalMessageSize, error);
+    return session->sendFrameInPlace(header, data, size, error);
 }
 
 /**
@@ -21,33 +21,106 @@
  */
 
 #include "multiblock_io.h"
+#include <multiblock_table.h>
+#include <path_sender.h>
 
 #include <libKitsunemimiSakuraNetwork/session.h>
 #include <libKitsunemimiCommon/logger.h>
 #include <messages_processing/multiblock_data_processing.h>
+#include <messages_processing/error_processing.h>
+
+#include <future>
+#include <algorithm>
 
 namespace Kitsunemimi
 {
 namespace Sakura
 {
 
+thread_local bool MultiblockIO::m_isSocketThread = false;
+
+// number of rejected multiblock-messages, which are remembered to ignore their remaining parts
+#define NUMBER_OF_REJECTED_MESSAGES 64
+
+// number of completed multiblock-messages, which are remembered to answer a resume of them
+#define NUMBER_OF_COMPLETED_MESSAGES 64
+
 MultiblockIO::MultiblockIO(Session* session)
 {
     m_session = session;
+    m_incomingBuffer = new MultiblockTable(MULTIBLOCK_TABLE_SIZE);
 }
 
 MultiblockIO::~MultiblockIO()
 {
     m_abort = true;
+    m_creditCondition.notify_all();
+    m_resumeCondition.notify_all();
     usleep(10000);
 
-    std::map<uint64_t, MultiblockBuffer>::iterator it;
-    for(it = m_incomingBuffer.begin();
-        it != m_incomingBuffer.end();
-        it++)
+    for(uint64_t i = 0; i < m_pathSenders.size(); i++) {
+        delete m_pathSenders[i];
+    }
+    m_pathSenders.clear();
+
+    // keep partial messages for a resume with a new session, if supported by the other side
+    const bool resumable = m_session->hasCapability(Session::RESUMABLE_MULTIBLOCK)
+                           && m_session->m_parentSession == nullptr;
+
+    for(uint32_t i = 0; i < m_incomingBuffer->getNumberOfSlots(); i++)
+    {
+        MultiblockSlot* slot = m_incomingBuffer->getSlot(i);
+        const uint64_t multiblockId = slot->key.load();
+        MultiblockBuffer buffer;
+        if(MultiblockTable::isValidId(multiblockId) == false
+                || m_incomingBuffer->remove(slot, multiblockId, false, buffer) == false)
+        {
+            continue;
+        }
+
+        if(resumable
+                && buffer.receivedParts > 0)
+        {
+            SessionHandler::m_sessionHandler->parkMultiblockBuffer(m_session->m_sessionIdentifier,
+                                                                   buffer);
+        }
+        else
+        {
+            releaseIncomingData(buffer);
+        }
+    }
+
+    // completed messages are also kept, so they are not delivered again by a resume
+    if(resumable)
     {
-        delete it->second.incomingData;
+        for(uint64_t i = 0; i < m_completedMessages.size(); i++)
+        {
+            SessionHandler::m_sessionHandler->parkMultiblockBuffer(m_session->m_sessionIdentifier,
+                                                                   m_completedMessages[i]);
+        }
     }
+
+    delete m_incomingBuffer;
+}
+
+/**
+ * @brief give the data-buffer of an incoming message back to the buffer-allocator, if it is
+ *        owned by the session
+ *
+ * @param buffer multiblock-message, which should be released
+ */
+void
+MultiblockIO::releaseIncomingData(MultiblockBuffer &buffer)
+{
+    if(buffer.incomingData != nullptr
+            && buffer.isExternal == false)
+    {
+        SessionHandler::m_sessionHandler->releaseBuffer(buffer.incomingData);
+    }
+
+    SessionHandler::m_sessionHandler->releaseMultiblockMemory(buffer.reservedMemory);
+    buffer.reservedMemory = 0;
+    buffer.incomingData = nullptr;
 }
 
 /**
@@ -57,6 +130,9 @@ MultiblockIO::~MultiblockIO()
  * @param size total size of the payload of the message (no header)
  * @param error reference for error-output
  * @param blockerId blocker-id in case that the message is a response
+ * @param multiblockId id for the message or 0 to create a new one
+ * @param resume true to ask the other side for the already received parts of the message and
+ *               send only the missing ones
  *
  * @return 0, if failed, else the multiblock-id of the message
  */
@@ -64,47 +140,110 @@ uint64_t
 MultiblockIO::sendOutgoingData(const void* data,
                                const uint64_t size,
                                ErrorContainer &error,
-                               const uint64_t blockerId)
+                               const uint64_t blockerId,
+                               const uint64_t multiblockId,
+                               const bool resume)
 {
     // set or create id
-    const uint64_t newMultiblockId = m_session->getRandId();
+    uint64_t newMultiblockId = multiblockId;
+    if(newMultiblockId == 0) {
+        newMultiblockId = m_session->getRandId();
+    }
+    const uint8_t* dataPointer = static_cast<const uint8_t*>(data);
 
-    // counter values
-    uint64_t totalSize = size;
-    uint64_t currentMessageSize = 0;
-    uint32_t partCounter = 0;
+    // get parts, which the other side has already received by a previous try
+    std::vector<uint64_t> receivedBitmap;
+    if(resume
+            && requestReceivedParts(newMultiblockId, size, receivedBitmap, error) == false)
+    {
+        return 0;
+    }
 
-    // static values
-    const uint32_t totalPartNumber = static_cast<uint32_t>(totalSize / MAX_SINGLE_MESSAGE_SIZE) + 1;
-    const uint8_t* dataPointer = static_cast<const uint8_t*>(data);
+    // limit the number of parts in flight, if the other side grants credits
+    const bool useCredits = m_session->hasCapability(Session::MULTIBLOCK_CREDITS)
+                            && m_isSocketThread == false;
+    m_lock.lock();
+    m_outgoingMessages.insert(std::make_pair(newMultiblockId, OutgoingMessage()));
+    m_lock.unlock();
 
-    while(totalSize != 0
-          && m_abort == false)
+    // spread the parts over all connections of the session, where each additional connection
+    // has its own long-lived sender-thread, so the costs of framing and encryption are spread
+    // over multiple cores
+    const std::vector<Session*> paths = m_session->getPaths();
+    const uint32_t numberOfPaths = static_cast<uint32_t>(paths.size());
+    std::vector<ErrorContainer> pathErrors(numberOfPaths);
+    std::vector<std::future<bool>> pathResults;
+
+    m_lock.lock();
+    while(m_pathSenders.size() + 1 < numberOfPaths)
     {
-        // get message-size base on the rest
-        currentMessageSize = MAX_SINGLE_MESSAGE_SIZE;
-        if(totalSize <= MAX_SINGLE_MESSAGE_SIZE) {
-            currentMessageSize = totalSize;
-        }
-        totalSize -= currentMessageSize;
+        PathSender* pathSender = new PathSender();
+        pathSender->startThread();
+        m_pathSenders.push_back(pathSender);
+    }
+    std::vector<PathSender*> pathSenders = m_pathSenders;
+    m_lock.unlock();
 
-        // send single packet
-        if(send_Data_Multi_Static(m_session,
-                                  size,
-                                  newMultiblockId,
-                                  totalPartNumber,
-                                  partCounter,
-                                  dataPointer + (MAX_SINGLE_MESSAGE_SIZE * partCounter),
-                                  static_cast<uint32_t>(currentMessageSize),
-                                  error) == false)
+    for(uint32_t i = 1; i < numberOfPaths; i++)
+    {
+        pathResults.push_back(pathSenders[i - 1]->addJob([&, i]
         {
-            return 0;
+            return sendParts(paths[i],
+                             dataPointer,
+                             size,
+                             newMultiblockId,
+                             i,
+                             numberOfPaths,
+                             useCredits,
+                             blockerId,
+                             receivedBitmap,
+                             pathErrors[i]);
+        }));
+    }
+
+    bool success = sendParts(m_session,
+                             dataPointer,
+                             size,
+                             newMultiblockId,
+                             0,
+                             numberOfPaths,
+                             useCredits,
+                             blockerId,
+                             receivedBitmap,
+                             error);
+
+    // the results of path i are at position i - 1
+    for(uint32_t i = 1; i < numberOfPaths; i++)
+    {
+        if(pathResults[i - 1].get()) {
+            continue;
         }
 
-        partCounter++;
+        const std::vector<std::string> &pathMessages = pathErrors[i]._errorMessages;
+        for(uint64_t j = 0; j < pathMessages.size(); j++) {
+            error.addMeesage(pathMessages[j]);
+        }
+        error.addMeesage("failed to send parts of multiblock-message over additional connection "
+                         + std::to_string(i));
+        success = false;
     }
 
-    if(m_abort) {
+    m_lock.lock();
+    const bool aborted = m_outgoingMessages[newMultiblockId].abort;
+    m_outgoingMessages.erase(newMultiblockId);
+    m_lock.unlock();
+
+    // tell the other side to drop the already received parts
+    if(aborted)
+    {
+        send_Data_Multi_Abort(m_session, newMultiblockId, error);
+        error.addMeesage("multiblock-message was aborted");
+        return 0;
+    }
+
+    if(success == false
+            || m_abort)
+    {
         return 0;
     }
 
@@ -117,85 +256,522 @@ MultiblockIO::sendOutgoingData(const void* data,
 }
 
 /**
- * @brief create new buffer for the message
+ * @brief send the parts of a multiblock-message, which belong to one connection
+ *
+ * @param path session of the connection, which should be used
+ * @param data payload of the complete message
+ * @param size total size of the payload of the message
+ * @param multiblockId id of the multiblock-message
+ * @param firstPart id of the first part to send
+ * @param partStep distance between the ids of the parts, which are send over this connection
+ * @param useCredits true to wait for credits of the other side before each part
+ * @param blockerId blocker-id in case that the message is a response
+ * @param receivedBitmap bitmap of the parts, which the other side has already received
+ * @param error reference for error-output
+ *
+ * @return false, if send failed or was aborted, else true
+ */
+bool
+MultiblockIO::sendParts(Session* path,
+                        const uint8_t* data,
+                        const uint64_t size,
+                        const uint64_t multiblockId,
+                        const uint32_t firstPart,
+                        const uint32_t partStep,
+                        const bool useCredits,
+                        const uint64_t blockerId,
+                        const std::vector<uint64_t> &receivedBitmap,
+                        ErrorContainer &error)
+{
+    // static values
+    const uint64_t partSize = m_session->getMultiblockPartSize();
+    const uint32_t totalPartNumber = static_cast<uint32_t>((size + partSize - 1) / partSize);
+
+    for(uint32_t partId = firstPart; partId < totalPartNumber; partId += partStep)
+    {
+        if(m_abort
+                || isAborted(multiblockId))
+        {
+            return false;
+        }
+
+        // skip parts, which the other side has already received
+        if(partId / 64 < receivedBitmap.size()
+                && (receivedBitmap[partId / 64] & (1ul << (partId % 64))) != 0)
+        {
+            continue;
+        }
+
+        // wait until the other side has free space for the next part
+        if(useCredits
+                && waitForCredit(multiblockId) == false)
+        {
+            error.addMeesage("timeout while waiting for credits of multiblock-message");
+            return false;
+        }
+
+        // get message-size base on the rest
+        const uint64_t offset = partSize * partId;
+        uint64_t currentMessageSize = partSize;
+        if(size - offset <= partSize) {
+            currentMessageSize = size - offset;
+        }
+
+        // send single packet
+        if(send_Data_Multi_Static(path,
+                                  size,
+                                  multiblockId,
+                                  totalPartNumber,
+                                  partId,
+                                  data + offset,
+                                  static_cast<uint32_t>(currentMessageSize),
+                                  error,
+                                  blockerId) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief create new buffer for the message, if not already exist. If the session has an
+ *        allocation-callback, the application is asked for the memory of the message first. If
+ *        the session has a part-callback, no buffer is created for messages, which are not
+ *        responses, because their parts are streamed to the callback.
  *
  * @param multiblockId id of the multiblock-message
  * @param size size for the new buffer
+ * @param numberOfParts number of parts of the message
+ * @param partSize size of each part, except the last one
+ * @param isResponse true, if the parts are flagged as response
  *
- * @return false, if allocation failed, else true
+ * @return false, if allocation failed or the message was rejected, else true
  */
 bool
 MultiblockIO::createIncomingBuffer(const uint64_t multiblockId,
-                                   const uint64_t size)
+                                   const uint64_t size,
+                                   const uint32_t numberOfParts,
+                                   const uint64_t partSize,
+                                   const bool isResponse)
 {
+    // fast path for all parts after the first one without lock
+    MultiblockSlot* slot = m_incomingBuffer->acquire(multiblockId);
+    if(slot != nullptr)
+    {
+        m_incomingBuffer->release(slot);
+        return true;
+    }
+
+    // the reserved keys of the table are never created by the sender
+    if(MultiblockTable::isValidId(multiblockId) == false)
+    {
+        LOG_WARNING("invalid multiblock-id: " + std::to_string(multiblockId));
+        return false;
+    }
+
+    // parts can arrive over multiple connections, so only the first one creates the buffer
+    std::lock_guard<std::mutex> createGuard(m_createLock);
+    slot = m_incomingBuffer->acquire(multiblockId);
+    if(slot != nullptr)
+    {
+        m_incomingBuffer->release(slot);
+        return true;
+    }
+
+    // ignore remaining parts of an already rejected message
+    m_lock.lock();
+    const bool rejected = std::find(m_rejectedMessages.begin(),
+                                    m_rejectedMessages.end(),
+                                    multiblockId) != m_rejectedMessages.end();
+    m_lock.unlock();
+    if(rejected) {
+        return false;
+    }
+
+    if(partSize == 0)
+    {
+        LOG_WARNING("invalid part-size of multiblock-message");
+        return false;
+    }
+
+    // check that the number of parts matches the size of the parts. Older versions of the other
+    // side announce one part more than they send, if the size is a multiple of the part-size,
+    // so for them the message is completed by the finish-message and the real number of parts.
+    const uint32_t realNumberOfParts = static_cast<uint32_t>((size + partSize - 1) / partSize);
+    const bool isLegacyNumber = m_session->hasCapability(Session::NEGOTIATED_SINGLE_SIZE) == false
+                                && numberOfParts == size / partSize + 1;
+    if(numberOfParts != realNumberOfParts
+            && isLegacyNumber == false)
+    {
+        LOG_WARNING("number of parts doesn't match the size of the multiblock-message");
+        return false;
+    }
+
     // init new multiblock-message
     MultiblockBuffer newMultiblockMessage;
-    newMultiblockMessage.incomingData = new Kitsunemimi::DataBuffer(calcBytesToBlocks(size));
     newMultiblockMessage.messageSize = size;
     newMultiblockMessage.multiblockId = multiblockId;
+    newMultiblockMessage.numberOfPackages = realNumberOfParts;
+    newMultiblockMessage.partSize = partSize;
+    newMultiblockMessage.receivedBitmap.resize((realNumberOfParts + 63) / 64, 0);
 
-    // check if memory allocation was successful
-    if(newMultiblockMessage.incomingData->data == nullptr)
+    if(m_session->m_processMultiblockPart != nullptr
+            && isResponse == false)
     {
-        delete newMultiblockMessage.incomingData;
-        return false;
+        newMultiblockMessage.isStreamed = true;
     }
+    else if(m_session->m_allocateMultiblock != nullptr)
+    {
+        DataBuffer* externalBuffer = nullptr;
+        externalBuffer = m_session->m_allocateMultiblock(m_session->m_allocationReceiver,
+                                                         m_session,
+                                                         multiblockId,
+                                                         size,
+                                                         isResponse);
+        if(externalBuffer != nullptr
+                && (externalBuffer->data == nullptr
+                    || externalBuffer->totalBufferSize < size))
+        {
+            LOG_WARNING("buffer of allocation-callback is too small for multiblock-message");
+            externalBuffer = nullptr;
+        }
 
-    // put buffer into message-queue to be filled with incoming data
-    m_lock.lock();
-    m_incomingBuffer.insert(std::make_pair(multiblockId, newMultiblockMessage));
-    m_lock.unlock();
+        if(externalBuffer != nullptr)
+        {
+            newMultiblockMessage.incomingData = externalBuffer;
+            newMultiblockMessage.isExternal = true;
+        }
+    }
+
+    if(newMultiblockMessage.isStreamed == false
+            && newMultiblockMessage.incomingData == nullptr)
+    {
+        // the announced size is only accepted within the memory-limits
+        if(reserveMemory(size) == false)
+        {
+            rejectIncomingBuffer(multiblockId, "memory-limit for multiblock-messages exceeded");
+            return false;
+        }
+        newMultiblockMessage.reservedMemory = size;
+        newMultiblockMessage.incomingData = SessionHandler::m_sessionHandler->allocateBuffer(size);
+
+        // check if memory allocation was successful
+        if(newMultiblockMessage.incomingData->data == nullptr)
+        {
+            m_lock.lock();
+            m_usedMemory -= size;
+            m_lock.unlock();
+            releaseIncomingData(newMultiblockMessage);
+            rejectIncomingBuffer(multiblockId, "failed to allocate buffer for multiblock-message");
+            return false;
+        }
+    }
+
+    // put buffer into the table to be filled with incoming data
+    slot = m_incomingBuffer->insert(newMultiblockMessage);
+    if(slot == nullptr)
+    {
+        m_lock.lock();
+        m_usedMemory -= newMultiblockMessage.reservedMemory;
+        m_lock.unlock();
+        releaseIncomingData(newMultiblockMessage);
+        rejectIncomingBuffer(multiblockId, "too many incomplete multiblock-messages");
+        return false;
+    }
+    m_incomingBuffer->release(slot);
 
     return true;
 }
 
+
 /**
- * @brief get incoming buffer by its id
+ * @brief write a part into the data-buffer for the multiblock-message at the position of the part.
+ *        Parts can arrive in any order. Each received part is marked in a bitmap, so a part,
+ *        which arrives twice, is counted only once. The message is searched without lock, so
+ *        parts of the same message can be written by multiple connections at the same time.
  *
  * @param multiblockId id of the multiblock-message
+ * @param partId id of the part within the message
+ * @param data pointer to the data
+ * @param size number of bytes
+ * @param newCredits reference for the number of credits, which should be given back to the
+ *                   sender, because enough parts are processed
+ * @param completeBuffer reference for the complete message, if this was the last missing part
  *
- * @return buffer, if found, else an empty-buffer-object
+ * @return true, if the message is complete, else false
  */
-MultiblockIO::MultiblockBuffer
-MultiblockIO::getIncomingBuffer(const uint64_t multiblockId)
+bool
+MultiblockIO::writeIntoIncomingBuffer(const uint64_t multiblockId,
+                                      const uint32_t partId,
+                                      const void* data,
+                                      const uint64_t size,
+                                      uint32_t &newCredits,
+                                      MultiblockBuffer &completeBuffer)
 {
-    std::lock_guard<std::mutex> guard(m_lock);
+    newCredits = 0;
 
-    std::map<uint64_t, MultiblockBuffer>::iterator it;
-    it = m_incomingBuffer.find(multiblockId);
-    if(it != m_incomingBuffer.end()) {
-        return it->second;
+    MultiblockSlot* slot = m_incomingBuffer->acquire(multiblockId);
+    if(slot == nullptr) {
+        return false;
     }
 
-    MultiblockBuffer tempBuffer;
-    return tempBuffer;
+    // check that the part has exactly the size of its position within the buffer
+    const MultiblockBuffer* buffer = &slot->buffer;
+    if(partId >= buffer->numberOfPackages)
+    {
+        m_incomingBuffer->release(slot);
+        LOG_WARNING("invalid part-id of multiblock-message");
+        return false;
+    }
+    const uint64_t offset = static_cast<uint64_t>(partId) * buffer->partSize;
+    const uint64_t expectedSize = std::min(buffer->partSize, buffer->messageSize - offset);
+    if(size != expectedSize)
+    {
+        m_incomingBuffer->release(slot);
+        LOG_WARNING("invalid part-size of multiblock-message");
+        return false;
+    }
+
+    if(buffer->isStreamed)
+    {
+        return streamIncomingPart(slot,
+                                  partId,
+                                  offset,
+                                  data,
+                                  size,
+                                  newCredits,
+                                  completeBuffer);
+    }
+
+    slot->lastActivity.store(MultiblockTable::getTimestamp(), std::memory_order_relaxed);
+    grantCredits(slot, newCredits);
+
+    // write and count part, if not already received
+    const uint64_t partBit = 1ul << (partId % 64);
+    const uint64_t oldBlock = slot->receivedBitmap[partId / 64].fetch_or(partBit);
+    if((oldBlock & partBit) != 0)
+    {
+        m_incomingBuffer->release(slot);
+        return false;
+    }
+
+    memcpy(static_cast<uint8_t*>(buffer->incomingData->data) + offset, data, size);
+    slot->receivedParts.fetch_add(1);
+
+    return takeCompleteBuffer(slot, completeBuffer);
 }
 
 /**
- * @brief append data to the data-buffer for the multiblock-message
+ * @brief give a part of a streamed multiblock-message to the part-callback of the session. The
+ *        delivery is serialized, so the callback with the last-flag is always the last one.
  *
- * @param multiblockId id of the multiblock-message
+ * @param slot acquired slot of the multiblock-message, which is released by this function
+ * @param partId id of the part within the message
+ * @param offset position of the part within the message
  * @param data pointer to the data
  * @param size number of bytes
+ * @param newCredits reference for the number of credits, which should be given back
+ * @param completeBuffer reference for the complete message, if this was the last missing part
  *
- * @return false, if session is not in the multiblock-transfer-state
+ * @return true, if the message is complete, else false
  */
 bool
-MultiblockIO::writeIntoIncomingBuffer(const uint64_t multiblockId,
-                                      const void* data,
-                                      const uint64_t size)
+MultiblockIO::streamIncomingPart(MultiblockSlot* slot,
+                                 const uint32_t partId,
+                                 const uint64_t offset,
+                                 const void* data,
+                                 const uint64_t size,
+                                 uint32_t &newCredits,
+                                 MultiblockBuffer &completeBuffer)
+{
+    std::unique_lock<std::mutex> deliveryLock(m_deliveryLock);
+
+    slot->lastActivity.store(MultiblockTable::getTimestamp(), std::memory_order_relaxed);
+    grantCredits(slot, newCredits);
+
+    // mark part, if not already received
+    const uint64_t partBit = 1ul << (partId % 64);
+    const uint64_t oldBlock = slot->receivedBitmap[partId / 64].fetch_or(partBit);
+    if((oldBlock & partBit) != 0)
+    {
+        m_incomingBuffer->release(slot);
+        return false;
+    }
+
+    const uint32_t receivedParts = slot->receivedParts.fetch_add(1) + 1;
+    const bool isLast = receivedParts == slot->buffer.numberOfPackages;
+
+    // other messages and credits can be processed by other connections while the callback
+    if(m_session->m_processMultiblockPart != nullptr)
+    {
+        m_session->m_processMultiblockPart(m_session->m_multiblockPartReceiver,
+                                           m_session,
+                                           slot->buffer.multiblockId,
+                                           offset,
+                                           data,
+                                           size,
+                                           isLast);
+    }
+
+    // the lock has to be released before the message is completed, because the removal from the
+    // table waits for other threads, which hold the slot and wait for the delivery-lock
+    deliveryLock.unlock();
+
+    return takeCompleteBuffer(slot, completeBuffer);
+}
+
+/**
+ * @brief count a received part and give credits back in batches to reduce the number of
+ *        credit-messages
+ *
+ * @param slot slot of the multiblock-message, which has received a part
+ * @param newCredits reference for the number of credits, which should be given back
+ */
+void
+MultiblockIO::grantCredits(MultiblockSlot* slot,
+                           uint32_t &newCredits)
+{
+    const uint32_t pendingCredits = slot->pendingCredits.fetch_add(1) + 1;
+    if(pendingCredits % MULTIBLOCK_CREDIT_BATCH == 0) {
+        newCredits = MULTIBLOCK_CREDIT_BATCH;
+    }
+}
+
+/**
+ * @brief mark a multiblock-message as finished by the sender
+ *
+ * @param multiblockId id of the multiblock-message
+ * @param blockerId blocker-id, if the message is a response
+ * @param isResponse true, if the message is a response for a request
+ * @param completeBuffer reference for the complete message, if all parts were already received
+ *
+ * @return true, if the message is complete, else false
+ */
+bool
+MultiblockIO::finishIncomingBuffer(const uint64_t multiblockId,
+                                   const uint64_t blockerId,
+                                   const bool isResponse,
+                                   MultiblockBuffer &completeBuffer)
+{
+    MultiblockSlot* slot = m_incomingBuffer->acquire(multiblockId);
+    if(slot == nullptr) {
+        return false;
+    }
+
+    // a finish-message, which arrives twice, is counted only once
+    if(slot->isFinished.exchange(true))
+    {
+        m_incomingBuffer->release(slot);
+        return false;
+    }
+
+    slot->buffer.blockerId = blockerId;
+    slot->buffer.isResponse = isResponse;
+    slot->lastActivity.store(MultiblockTable::getTimestamp(), std::memory_order_relaxed);
+
+    return takeCompleteBuffer(slot, completeBuffer);
+}
+
+/**
+ * @brief count a new part or the finish-message of a multiblock-message and remove the message
+ *        from the table, if all parts and the finish-message were received. Because the bitmap
+ *        prevents double counting, only the thread with the last missing event completes the
+ *        message.
+ *
+ * @param slot acquired slot of the multiblock-message, which is released by this function
+ * @param completeBuffer reference for the complete message
+ *
+ * @return true, if the message is complete, else false
+ */
+bool
+MultiblockIO::takeCompleteBuffer(MultiblockSlot* slot,
+                                 MultiblockBuffer &completeBuffer)
 {
-    bool result = false;
+    const uint64_t multiblockId = slot->buffer.multiblockId;
+    if(slot->missingEvents.fetch_sub(1) != 1)
+    {
+        m_incomingBuffer->release(slot);
+        return false;
+    }
+
+    // the message could be aborted by another thread in the meantime
+    const bool removed = m_incomingBuffer->remove(slot, multiblockId, true, completeBuffer);
+    m_incomingBuffer->release(slot);
+    if(removed == false) {
+        return false;
+    }
+
+    if(completeBuffer.incomingData != nullptr) {
+        completeBuffer.incomingData->usedBufferSize = completeBuffer.messageSize;
+    }
+
+    // the complete message belongs to the application and is not counted anymore
+    m_lock.lock();
+    m_usedMemory -= completeBuffer.reservedMemory;
+    m_lock.unlock();
+    SessionHandler::m_sessionHandler->releaseMultiblockMemory(completeBuffer.reservedMemory);
+    completeBuffer.reservedMemory = 0;
+
+    // the sender of a resumable message may not know, that the message is already complete
+    if(m_session->hasCapability(Session::RESUMABLE_MULTIBLOCK)) {
+        addCompletedBuffer(completeBuffer);
+    }
+
+    return true;
+}
+
+/**
+ * @brief remember the values of a completed multiblock-message without its data, so a resume of
+ *        this message can be answered with all parts as received
+ *
+ * @param completeBuffer completed multiblock-message
+ */
+void
+MultiblockIO::addCompletedBuffer(const MultiblockBuffer &completeBuffer)
+{
+    MultiblockBuffer completed;
+    completed.multiblockId = completeBuffer.multiblockId;
+    completed.messageSize = completeBuffer.messageSize;
+    completed.numberOfPackages = completeBuffer.numberOfPackages;
+    completed.receivedParts = completeBuffer.numberOfPackages;
+    completed.partSize = completeBuffer.partSize;
+    completed.isFinished = true;
+
     std::lock_guard<std::mutex> guard(m_lock);
 
-    std::map<uint64_t, MultiblockBuffer>::iterator it;
-    it = m_incomingBuffer.find(multiblockId);
+    m_completedMessages.push_back(completed);
+    if(m_completedMessages.size() > NUMBER_OF_COMPLETED_MESSAGES) {
+        m_completedMessages.pop_front();
+    }
+}
 
-    if(it != m_incomingBuffer.end()) {
-        result = Kitsunemimi::addData_DataBuffer(*it->second.incomingData, data, size);
+/**
+ * @brief check if a multiblock-message was already completed
+ *
+ * @param buffer multiblock-message with the values of the resume-request
+ *
+ * @return true, if a message with the same values was completed, else false
+ */
+bool
+MultiblockIO::isCompletedBuffer(const MultiblockBuffer &buffer)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    for(uint64_t i = 0; i < m_completedMessages.size(); i++)
+    {
+        const MultiblockBuffer* completed = &m_completedMessages[i];
+        if(completed->multiblockId == buffer.multiblockId
+                && completed->messageSize == buffer.messageSize
+                && completed->numberOfPackages == buffer.numberOfPackages
+                && completed->partSize == buffer.partSize)
+        {
+            return true;
+        }
     }
 
-    return result;
+    return false;
 }
 
 /**
@@ -208,19 +784,452 @@ MultiblockIO::writeIntoIncomingBuffer(const uint64_t multiblockId,
  */
 bool
 MultiblockIO::removeMultiblockBuffer(const uint64_t multiblockId)
+{
+    MultiblockSlot* slot = m_incomingBuffer->acquire(multiblockId);
+    if(slot == nullptr) {
+        return false;
+    }
+
+    MultiblockBuffer removedBuffer;
+    const bool removed = m_incomingBuffer->remove(slot, multiblockId, true, removedBuffer);
+    m_incomingBuffer->release(slot);
+
+    return removed;
+}
+
+/**
+ * @brief add credits, which were granted by the other side, to an outgoing multiblock-message
+ *
+ * @param multiblockId id of the multiblock-message
+ * @param credits number of parts, which can be sent additionally
+ */
+void
+MultiblockIO::addCredits(const uint64_t multiblockId,
+                         const uint32_t credits)
 {
     std::lock_guard<std::mutex> guard(m_lock);
 
-    std::map<uint64_t, MultiblockBuffer>::iterator it;
-    it = m_incomingBuffer.find(multiblockId);
-    if(it != m_incomingBuffer.end())
+    std::map<uint64_t, OutgoingMessage>::iterator it;
+    it = m_outgoingMessages.find(multiblockId);
+    if(it != m_outgoingMessages.end())
     {
-        m_incomingBuffer.erase(it);
-        return true;
+        it->second.credits += credits;
+        m_creditCondition.notify_all();
+    }
+}
+
+/**
+ * @brief wait until there is a credit for the next part of an outgoing multiblock-message and
+ *        take it
+ *
+ * @param multiblockId id of the multiblock-message
+ *
+ * @return false, if no credit was granted before the timeout or the transfer was aborted, else true
+ */
+bool
+MultiblockIO::waitForCredit(const uint64_t multiblockId)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    OutgoingMessage* message = &m_outgoingMessages[multiblockId];
+    const bool ret = m_creditCondition.wait_for(lock,
+                                                std::chrono::seconds(MULTIBLOCK_CREDIT_TIMEOUT),
+                                                [&] {
+                                                    return message->credits > 0
+                                                           || message->abort
+                                                           || m_abort
+                                                           || m_session->isReady() == false;
+                                                });
+    if(ret == false
+            || message->abort
+            || m_abort
+            || m_session->isReady() == false)
+    {
+        return false;
+    }
+
+    message->credits--;
+
+    return true;
+}
+
+/**
+ * @brief check if an outgoing multiblock-message was aborted
+ *
+ * @param multiblockId id of the multiblock-message
+ *
+ * @return true, if aborted, else false
+ */
+bool
+MultiblockIO::isAborted(const uint64_t multiblockId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::map<uint64_t, OutgoingMessage>::iterator it;
+    it = m_outgoingMessages.find(multiblockId);
+    if(it != m_outgoingMessages.end()) {
+        return it->second.abort;
     }
 
     return false;
 }
 
+/**
+ * @brief abort an outgoing multiblock-message, which is currently sent
+ *
+ * @param multiblockId id of the multiblock-message
+ *
+ * @return false, if no outgoing message with the id was found, else true
+ */
+bool
+MultiblockIO::abortOutgoingData(const uint64_t multiblockId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::map<uint64_t, OutgoingMessage>::iterator it;
+    it = m_outgoingMessages.find(multiblockId);
+    if(it == m_outgoingMessages.end()) {
+        return false;
+    }
+
+    it->second.abort = true;
+    m_creditCondition.notify_all();
+
+    return true;
+}
+
+/**
+ * @brief drop an incoming multiblock-message, which was aborted by the sender, and release its
+ *        buffer
+ *
+ * @param multiblockId id of the multiblock-message
+ *
+ * @return false, if no incoming message with the id was found, else true
+ */
+bool
+MultiblockIO::abortIncomingBuffer(const uint64_t multiblockId)
+{
+    MultiblockSlot* slot = m_incomingBuffer->acquire(multiblockId);
+    if(slot == nullptr) {
+        return false;
+    }
+
+    const bool removed = removeIncomingBuffer(slot, multiblockId, true);
+    m_incomingBuffer->release(slot);
+
+    return removed;
+}
+
+/**
+ * @brief remove all incomplete incoming multiblock-messages, which didn't get new parts within
+ *        the idle-timeout. The error-callback is not called here, so the caller can report the
+ *        removed messages after all of its locks are released.
+ *
+ * @param idleTimeout time in seconds
+ * @param errorMessages reference for the error-messages of the removed messages
+ */
+void
+MultiblockIO::removeIdleBuffers(const uint32_t idleTimeout,
+                                std::vector<std::string> &errorMessages)
+{
+    const int64_t now = MultiblockTable::getTimestamp();
+    const int64_t timeout = static_cast<int64_t>(idleTimeout) * 1000000000l;
+
+    for(uint32_t i = 0; i < m_incomingBuffer->getNumberOfSlots(); i++)
+    {
+        MultiblockSlot* slot = m_incomingBuffer->getSlot(i);
+        const uint64_t multiblockId = slot->key.load();
+        if(MultiblockTable::isValidId(multiblockId) == false
+                || now - slot->lastActivity.load() <= timeout)
+        {
+            continue;
+        }
+
+        if(removeIncomingBuffer(slot, multiblockId, false))
+        {
+            const std::string err = "remove idle multiblock-message: "
+                                    + std::to_string(multiblockId);
+            LOG_WARNING(err);
+            errorMessages.push_back(err);
+        }
+    }
+}
+
+/**
+ * @brief reserve memory for a new incoming multiblock-message within the limit of the session
+ *        and the limit of all sessions
+ *
+ * @param size number of bytes
+ *
+ * @return false, if one of the limits would be exceeded, else true
+ */
+bool
+MultiblockIO::reserveMemory(const uint64_t size)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if(m_usedMemory + size > SessionHandler::m_sessionHandler->m_maxSessionMultiblockMemory) {
+        return false;
+    }
+
+    if(SessionHandler::m_sessionHandler->reserveMultiblockMemory(size) == false) {
+        return false;
+    }
+
+    m_usedMemory += size;
+
+    return true;
+}
+
+/**
+ * @brief reject a new incoming multiblock-message. The other side gets an error-message and the
+ *        message is aborted, so the sender stops to send further parts.
+ *
+ * @param multiblockId id of the multiblock-message
+ * @param reason error-message for the other side
+ */
+void
+MultiblockIO::rejectIncomingBuffer(const uint64_t multiblockId,
+                                   const std::string &reason)
+{
+    LOG_WARNING(reason + ": " + std::to_string(multiblockId));
+
+    m_lock.lock();
+    m_rejectedMessages.push_back(multiblockId);
+    if(m_rejectedMessages.size() > NUMBER_OF_REJECTED_MESSAGES) {
+        m_rejectedMessages.pop_front();
+    }
+    m_lock.unlock();
+
+    const std::string err = reason + ": " + std::to_string(multiblockId);
+    send_ErrorMessage(m_session,
+                      Session::errorCodes::MULTIBLOCK_FAILED,
+                      err,
+                      m_session->sessionError);
+    send_Data_Multi_Abort(m_session, multiblockId, m_session->sessionError);
+}
+
+/**
+ * @brief remove an incoming multiblock-message from the table and release its memory
+ *
+ * @param slot slot of the multiblock-message
+ * @param multiblockId id of the multiblock-message
+ * @param isUser true, if the slot is acquired by the caller
+ *
+ * @return false, if the message was already removed by another thread, else true
+ */
+bool
+MultiblockIO::removeIncomingBuffer(MultiblockSlot* slot,
+                                   const uint64_t multiblockId,
+                                   const bool isUser)
+{
+    MultiblockBuffer removedBuffer;
+    if(m_incomingBuffer->remove(slot, multiblockId, isUser, removedBuffer) == false) {
+        return false;
+    }
+
+    m_lock.lock();
+    m_usedMemory -= removedBuffer.reservedMemory;
+    m_lock.unlock();
+    releaseIncomingData(removedBuffer);
+
+    return true;
+}
+
+/**
+ * @brief ask the other side for the parts of an outgoing multiblock-message, which were already
+ *        received by a previous try, and wait for the answer
+ *
+ * @param multiblockId id of the multiblock-message
+ * @param size total size of the payload of the message
+ * @param receivedBitmap reference for the bitmap of the received parts
+ * @param error reference for error-output
+ *
+ * @return false, if the request failed or timed out, else true
+ */
+bool
+MultiblockIO::requestReceivedParts(const uint64_t multiblockId,
+                                   const uint64_t size,
+                                   std::vector<uint64_t> &receivedBitmap,
+                                   ErrorContainer &error)
+{
+    // the answer is processed by the thread of the socket, so it can not wait for it
+    if(m_isSocketThread)
+    {
+        error.addMeesage("multiblock-message can not be resumed within a callback");
+        return false;
+    }
+
+    const uint64_t partSize = m_session->getMultiblockPartSize();
+    const uint32_t totalPartNumber = static_cast<uint32_t>((size + partSize - 1) / partSize);
+
+    m_lock.lock();
+    m_receivedParts[multiblockId] = ReceivedParts();
+    m_lock.unlock();
+
+    if(send_Data_Multi_Resume(m_session, multiblockId, size, totalPartNumber, error) == false)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_receivedParts.erase(multiblockId);
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    ReceivedParts* receivedParts = &m_receivedParts[multiblockId];
+    const bool ret = m_resumeCondition.wait_for(lock,
+                                                std::chrono::seconds(MULTIBLOCK_RESUME_TIMEOUT),
+                                                [&] {
+                                                    return receivedParts->isReady
+                                                           || m_abort
+                                                           || m_session->isReady() == false;
+                                                });
+    receivedBitmap.swap(receivedParts->receivedBitmap);
+    const bool isReady = receivedParts->isReady;
+    m_receivedParts.erase(multiblockId);
+
+    if(ret == false
+            || isReady == false
+            || m_abort)
+    {
+        error.addMeesage("timeout while waiting for the received parts of multiblock-message");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief set the parts of a resumed outgoing multiblock-message, which were reported by the
+ *        other side, and wake up the waiting sender
+ *
+ * @param multiblockId id of the multiblock-message
+ * @param receivedBitmap bitmap with one bit for each received part
+ * @param numberOfBlocks number of uint64_t-values of the bitmap
+ */
+void
+MultiblockIO::setReceivedParts(const uint64_t multiblockId,
+                               const uint64_t* receivedBitmap,
+                               const uint64_t numberOfBlocks)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::map<uint64_t, ReceivedParts>::iterator it;
+    it = m_receivedParts.find(multiblockId);
+    if(it != m_receivedParts.end())
+    {
+        it->second.receivedBitmap.assign(receivedBitmap, receivedBitmap + numberOfBlocks);
+        it->second.isReady = true;
+        m_resumeCondition.notify_all();
+    }
+}
+
+/**
+ * @brief wake up all senders, which are waiting for credits or for the received parts of the other
+ *        side, because the session was closed
+ */
+void
+MultiblockIO::wakeUpSenders()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_creditCondition.notify_all();
+    m_resumeCondition.notify_all();
+}
+
+/**
+ * @brief prepare an incoming multiblock-message for a resume by the sender. If the message is
+ *        not already known by this session, a partial message of a closed session with the same
+ *        session-identifier is taken back.
+ *
+ * @param multiblockId id of the multiblock-message
+ * @param size total size of the message
+ * @param numberOfParts number of parts of the message
+ * @param partSize size of each part, except the last one
+ * @param receivedBitmap reference for the bitmap of the already received parts
+ *
+ * @return true, if parts of the message were found, else false
+ */
+bool
+MultiblockIO::resumeIncomingBuffer(const uint64_t multiblockId,
+                                   const uint64_t size,
+                                   const uint32_t numberOfParts,
+                                   const uint64_t partSize,
+                                   std::vector<uint64_t> &receivedBitmap)
+{
+    receivedBitmap.clear();
+    std::lock_guard<std::mutex> createGuard(m_createLock);
+
+    // message is still known by this session
+    MultiblockSlot* slot = m_incomingBuffer->acquire(multiblockId);
+    if(slot != nullptr)
+    {
+        slot->pendingCredits.store(0);
+        receivedBitmap.resize(slot->receivedBitmap.size());
+        for(uint64_t i = 0; i < slot->receivedBitmap.size(); i++) {
+            receivedBitmap[i] = slot->receivedBitmap[i].load();
+        }
+        m_incomingBuffer->release(slot);
+        return true;
+    }
+
+    MultiblockBuffer requested;
+    requested.multiblockId = multiblockId;
+    requested.messageSize = size;
+    requested.numberOfPackages = numberOfParts;
+    requested.partSize = partSize;
+
+    // message was already completed, so all parts are reported as received and the message is
+    // not delivered again
+    if(isCompletedBuffer(requested))
+    {
+        receivedBitmap.assign((numberOfParts + 63) / 64, ~0ul);
+        return true;
+    }
+
+    // get partial message of a closed session
+    MultiblockBuffer parkedBuffer;
+    if(SessionHandler::m_sessionHandler->takeParkedMultiblockBuffer(m_session->m_sessionIdentifier,
+                                                                    multiblockId,
+                                                                    parkedBuffer) == false)
+    {
+        return false;
+    }
+
+    // the parts can only be reused, if they were split in the same way
+    if(parkedBuffer.messageSize != size
+            || parkedBuffer.numberOfPackages != numberOfParts
+            || parkedBuffer.partSize != partSize)
+    {
+        releaseIncomingData(parkedBuffer);
+        return false;
+    }
+
+    // message was already completed by the closed session
+    if(parkedBuffer.isFinished
+            && parkedBuffer.receivedParts == parkedBuffer.numberOfPackages)
+    {
+        addCompletedBuffer(parkedBuffer);
+        receivedBitmap.assign((numberOfParts + 63) / 64, ~0ul);
+        return true;
+    }
+
+    parkedBuffer.pendingCredits = 0;
+    parkedBuffer.isFinished = false;
+
+    slot = m_incomingBuffer->insert(parkedBuffer);
+    if(slot == nullptr)
+    {
+        releaseIncomingData(parkedBuffer);
+        return false;
+    }
+    m_incomingBuffer->release(slot);
+    receivedBitmap = parkedBuffer.receivedBitmap;
+
+    // the memory is still reserved within the limit of all sessions
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_usedMemory += parkedBuffer.reservedMemory;
+
+    return true;
+}
+
 } // namespace Sakura
 } // namespace Kitsunemimi
@@ -28,8 +28,14 @@
 #include <atomic>
 #include <utility>
 #include <deque>
+#include <vector>
 #include <map>
 #include <string>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+#include <message_definitions.h>
 
 #include <libKitsunemimiCommon/buffer/data_buffer.h>
 #include <libKitsunemimiCommon/logger.h>
@@ -39,6 +45,9 @@ namespace Kitsunemimi
 namespace Sakura
 {
 class Session;
+class MultiblockTable;
+class PathSender;
+struct MultiblockSlot;
 
 class MultiblockIO
 {
@@ -51,6 +60,23 @@ public:
         uint64_t messageSize = 0;
         uint32_t numberOfPackages = 0;
         uint32_t courrentPackage = 0;
+        uint32_t pendingCredits = 0;
+        uint32_t receivedParts = 0;
+        uint64_t partSize = 0;
+        bool isFinished = false;
+        bool isResponse = false;
+
+        // true, if the buffer was provided by the application and is not released by the session
+        bool isExternal = false;
+
+        // true, if each part is given directly to the part-callback without buffer
+        bool isStreamed = false;
+
+        // one bit for each part, which was already received
+        std::vector<uint64_t> receivedBitmap;
+
+        // memory, which is counted against the limits
+        uint64_t reservedMemory = 0;
 
         Kitsunemimi::DataBuffer* incomingData = nullptr;
     };
@@ -62,23 +88,120 @@ public:
     uint64_t sendOutgoingData(const void* data,
                               const uint64_t size,
                               ErrorContainer &error,
-                              const uint64_t blockerId = 0);
+                              const uint64_t blockerId = 0,
+                              const uint64_t multiblockId = 0,
+                              const bool resume = false);
     bool createIncomingBuffer(const uint64_t multiblockId,
-                              const uint64_t size);
+                              const uint64_t size,
+                              const uint32_t numberOfParts,
+                              const uint64_t partSize,
+                              const bool isResponse);
 
     // process incoming
-    MultiblockBuffer getIncomingBuffer(const uint64_t multiblockId);
     bool writeIntoIncomingBuffer(const uint64_t multiblockId,
+                                 const uint32_t partId,
                                  const void* data,
-                                 const uint64_t size);
+                                 const uint64_t size,
+                                 uint32_t &newCredits,
+                                 MultiblockBuffer &completeBuffer);
+    bool finishIncomingBuffer(const uint64_t multiblockId,
+                              const uint64_t blockerId,
+                              const bool isResponse,
+                              MultiblockBuffer &completeBuffer);
     bool removeMultiblockBuffer(const uint64_t multiblockId);
 
+    // abort
+    bool abortOutgoingData(const uint64_t multiblockId);
+    bool abortIncomingBuffer(const uint64_t multiblockId);
+    void removeIdleBuffers(const uint32_t idleTimeout,
+                           std::vector<std::string> &errorMessages);
+
+    // flow-control
+    void addCredits(const uint64_t multiblockId,
+                    const uint32_t credits);
+
+    // resumable transfers
+    bool resumeIncomingBuffer(const uint64_t multiblockId,
+                              const uint64_t size,
+                              const uint32_t numberOfParts,
+                              const uint64_t partSize,
+                              std::vector<uint64_t> &receivedBitmap);
+    void setReceivedParts(const uint64_t multiblockId,
+                          const uint64_t* receivedBitmap,
+                          const uint64_t numberOfBlocks);
+    void wakeUpSenders();
+
+    static void releaseIncomingData(MultiblockBuffer &buffer);
+    static thread_local bool m_isSocketThread;
+
 private:
     Session* m_session = nullptr;
     bool m_abort = false;
 
     std::mutex m_lock;
-    std::map<uint64_t, MultiblockBuffer> m_incomingBuffer;
+    std::mutex m_createLock;
+    std::mutex m_deliveryLock;
+    MultiblockTable* m_incomingBuffer = nullptr;
+    std::deque<uint64_t> m_rejectedMessages;
+    std::deque<MultiblockBuffer> m_completedMessages;
+    uint64_t m_usedMemory = 0;
+
+    // state of outgoing multiblock-messages, which are currently sent
+    struct OutgoingMessage
+    {
+        uint32_t credits = MULTIBLOCK_INITIAL_CREDITS;
+        bool abort = false;
+    };
+    std::map<uint64_t, OutgoingMessage> m_outgoingMessages;
+    std::condition_variable m_creditCondition;
+
+    // long-lived threads to send parts over the additional connections of the session
+    std::vector<PathSender*> m_pathSenders;
+
+    // received parts, which were reported by the other side for a resumed outgoing message
+    struct ReceivedParts
+    {
+        bool isReady = false;
+        std::vector<uint64_t> receivedBitmap;
+    };
+    std::map<uint64_t, ReceivedParts> m_receivedParts;
+    std::condition_variable m_resumeCondition;
+
+    bool waitForCredit(const uint64_t multiblockId);
+    bool isAborted(const uint64_t multiblockId);
+    bool requestReceivedParts(const uint64_t multiblockId,
+                              const uint64_t size,
+                              std::vector<uint64_t> &receivedBitmap,
+                              ErrorContainer &error);
+    bool sendParts(Session* path,
+                   const uint8_t* data,
+                   const uint64_t size,
+                   const uint64_t multiblockId,
+                   const uint32_t firstPart,
+                   const uint32_t partStep,
+                   const bool useCredits,
+                   const uint64_t blockerId,
+                   const std::vector<uint64_t> &receivedBitmap,
+                   ErrorContainer &error);
+    bool streamIncomingPart(MultiblockSlot* slot,
+                            const uint32_t partId,
+                            const uint64_t offset,
+                            const void* data,
+                            const uint64_t size,
+                            uint32_t &newCredits,
+                            MultiblockBuffer &completeBuffer);
+    void grantCredits(MultiblockSlot* slot,
+                      uint32_t &newCredits);
+    bool reserveMemory(const uint64_t size);
+    void rejectIncomingBuffer(const uint64_t multiblockId,
+                              const std::string &reason);
+    bool removeIncomingBuffer(MultiblockSlot* slot,
+                              const uint64_t multiblockId,
+                              const bool isUser);
+    bool takeCompleteBuffer(MultiblockSlot* slot,
+                            MultiblockBuffer &completeBuffer);
+    void addCompletedBuffer(const MultiblockBuffer &completeBuffer);
+    bool isCompletedBuffer(const MultiblockBuffer &buffer);
 };
 
 } // namespace Sakura
@@ -0,0 +1,295 @@
+/**
+ * @file       multiblock_table.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "multiblock_table.h"
+
+#include <thread>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief constructor
+ *
+ * @param numberOfSlots number of slots of the table, which is rounded up to a power of two. At
+ *                      most 3/4 of the slots can be used at the same time.
+ */
+MultiblockTable::MultiblockTable(const uint32_t numberOfSlots)
+{
+    m_numberOfBits = 1;
+    while((1u << m_numberOfBits) < numberOfSlots) {
+        m_numberOfBits++;
+    }
+
+    m_numberOfSlots = 1u << m_numberOfBits;
+    m_slots = new MultiblockSlot[m_numberOfSlots];
+}
+
+/**
+ * @brief destructor
+ */
+MultiblockTable::~MultiblockTable()
+{
+    delete[] m_slots;
+}
+
+/**
+ * @brief add a new multiblock-message to the table. The multiblock-id must not already exist
+ *        within the table.
+ *
+ * @param buffer new multiblock-message, which can already have received parts in case of a resume
+ *
+ * @return pointer to the new slot, which has to be released by the caller, or nullptr, if the
+ *         table is full or the multiblock-id is invalid
+ */
+MultiblockSlot*
+MultiblockTable::insert(const MultiblockIO::MultiblockBuffer &buffer)
+{
+    if(isValidId(buffer.multiblockId) == false) {
+        return nullptr;
+    }
+
+    // only inserting and removing is serialized, reading is possible at any time
+    std::lock_guard<std::mutex> guard(m_writeLock);
+    if(m_numberOfEntries.load() >= m_numberOfSlots - m_numberOfSlots / 4) {
+        return nullptr;
+    }
+
+    // search free slot
+    const uint32_t start = getStartPosition(buffer.multiblockId);
+    for(uint32_t i = 0; i < m_numberOfSlots; i++)
+    {
+        MultiblockSlot* slot = &m_slots[(start + i) & (m_numberOfSlots - 1)];
+        const uint64_t key = slot->key.load();
+        if(key != EMPTY_SLOT_KEY
+                && key != DELETED_SLOT_KEY)
+        {
+            continue;
+        }
+
+        // fill slot before it becomes visible for other threads
+        slot->buffer = buffer;
+        slot->buffer.receivedBitmap.clear();
+        slot->receivedBitmap = std::vector<std::atomic<uint64_t>>(buffer.receivedBitmap.size());
+        for(uint64_t j = 0; j < buffer.receivedBitmap.size(); j++) {
+            slot->receivedBitmap[j].store(buffer.receivedBitmap[j]);
+        }
+        slot->receivedParts.store(buffer.receivedParts);
+        slot->missingEvents.store(buffer.numberOfPackages - buffer.receivedParts + 1);
+        slot->pendingCredits.store(0);
+        slot->isFinished.store(false);
+        slot->lastActivity.store(getTimestamp());
+        slot->users.fetch_add(1);
+
+        m_numberOfEntries++;
+        slot->key.store(buffer.multiblockId);
+
+        return slot;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief get the slot of a multiblock-message without lock. The slot can not be removed by
+ *        another thread until it was released again.
+ *
+ * @param multiblockId id of the multiblock-message
+ *
+ * @return pointer to the slot, which has to be released by the caller, or nullptr, if not found
+ */
+MultiblockSlot*
+MultiblockTable::acquire(const uint64_t multiblockId)
+{
+    if(isValidId(multiblockId) == false) {
+        return nullptr;
+    }
+
+    const uint32_t start = getStartPosition(multiblockId);
+    for(uint32_t i = 0; i < m_numberOfSlots; i++)
+    {
+        MultiblockSlot* slot = &m_slots[(start + i) & (m_numberOfSlots - 1)];
+        const uint64_t key = slot->key.load();
+        if(key == EMPTY_SLOT_KEY) {
+            return nullptr;
+        }
+
+        if(key != multiblockId) {
+            continue;
+        }
+
+        // register as user and check, that the slot was not removed in the meantime
+        slot->users.fetch_add(1);
+        if(slot->key.load() == multiblockId) {
+            return slot;
+        }
+        slot->users.fetch_sub(1);
+
+        return nullptr;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief give a slot back, which was acquired or inserted before
+ *
+ * @param slot pointer to the slot
+ */
+void
+MultiblockTable::release(MultiblockSlot* slot)
+{
+    slot->users.fetch_sub(1);
+}
+
+/**
+ * @brief remove a multiblock-message from the table. The call waits until all other users have
+ *        released the slot.
+ *
+ * @param slot pointer to the slot of the message
+ * @param multiblockId id of the multiblock-message
+ * @param isUser true, if the caller has acquired the slot and still holds it
+ * @param removedBuffer reference for the content of the slot
+ *
+ * @return false, if the message was already removed by another thread, else true
+ */
+bool
+MultiblockTable::remove(MultiblockSlot* slot,
+                        const uint64_t multiblockId,
+                        const bool isUser,
+                        MultiblockIO::MultiblockBuffer &removedBuffer)
+{
+    // only one thread can win the removal
+    uint64_t expected = multiblockId;
+    if(slot->key.compare_exchange_strong(expected, REMOVING_SLOT_KEY) == false) {
+        return false;
+    }
+
+    // other users hold the slot only for the processing of one part
+    const uint32_t ownUsers = isUser ? 1 : 0;
+    while(slot->users.load() > ownUsers) {
+        std::this_thread::yield();
+    }
+
+    // copy content of the slot
+    removedBuffer = slot->buffer;
+    removedBuffer.receivedBitmap.resize(slot->receivedBitmap.size());
+    for(uint64_t i = 0; i < slot->receivedBitmap.size(); i++) {
+        removedBuffer.receivedBitmap[i] = slot->receivedBitmap[i].load();
+    }
+    removedBuffer.receivedParts = slot->receivedParts.load();
+    removedBuffer.pendingCredits = slot->pendingCredits.load();
+    removedBuffer.isFinished = slot->isFinished.load();
+
+    slot->buffer = MultiblockIO::MultiblockBuffer();
+    slot->receivedBitmap.clear();
+
+    std::lock_guard<std::mutex> guard(m_writeLock);
+    m_numberOfEntries--;
+
+    // a slot can only become empty again, if no search has to continue behind it
+    const uint32_t position = static_cast<uint32_t>(slot - m_slots);
+    if(getSlot(position + 1)->key.load() != EMPTY_SLOT_KEY)
+    {
+        slot->key.store(DELETED_SLOT_KEY);
+        return true;
+    }
+
+    slot->key.store(EMPTY_SLOT_KEY);
+
+    // deleted slots directly before the new empty slot are not necessary anymore
+    uint32_t previous = position - 1;
+    while(getSlot(previous)->key.load() == DELETED_SLOT_KEY)
+    {
+        getSlot(previous)->key.store(EMPTY_SLOT_KEY);
+        previous--;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get number of slots of the table
+ */
+uint32_t
+MultiblockTable::getNumberOfSlots() const
+{
+    return m_numberOfSlots;
+}
+
+/**
+ * @brief get slot by its position to iterate over the table
+ *
+ * @param index position of the slot
+ *
+ * @return pointer to the slot, which is not acquired
+ */
+MultiblockSlot*
+MultiblockTable::getSlot(const uint32_t index)
+{
+    return &m_slots[index & (m_numberOfSlots - 1)];
+}
+
+/**
+ * @brief check if a multiblock-id can be used within the table
+ *
+ * @param multiblockId id to check
+ *
+ * @return false, if the id is one of the reserved keys, else true
+ */
+bool
+MultiblockTable::isValidId(const uint64_t multiblockId)
+{
+    return multiblockId > REMOVING_SLOT_KEY;
+}
+
+/**
+ * @brief get the actual time for the last activity of a slot
+ *
+ * @return nanoseconds of the steady clock
+ */
+int64_t
+MultiblockTable::getTimestamp()
+{
+    const std::chrono::steady_clock::duration time =
+            std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+/**
+ * @brief get the first position to search for a multiblock-id within the table
+ *
+ * @param multiblockId id of the multiblock-message
+ *
+ * @return position within the table
+ */
+uint32_t
+MultiblockTable::getStartPosition(const uint64_t multiblockId) const
+{
+    // fibonacci-hashing to spread also ids, which are not random
+    return static_cast<uint32_t>((multiblockId * 0x9E3779B97F4A7C15ul) >> (64 - m_numberOfBits));
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,97 @@
+/**
+ * @file       multiblock_table.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_MULTIBLOCK_TABLE_H
+#define KITSUNEMIMI_SAKURA_NETWORK_MULTIBLOCK_TABLE_H
+
+#include <iostream>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <mutex>
+
+#include <multiblock_io.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+// reserved keys of the slots, which are never used as multiblock-id
+#define EMPTY_SLOT_KEY 0
+#define DELETED_SLOT_KEY 1
+#define REMOVING_SLOT_KEY 2
+
+// slot of an incoming multiblock-message. All values, which are changed by incoming parts,
+// are atomic, so the parts can be written without lock.
+struct MultiblockSlot
+{
+    std::atomic<uint64_t> key{EMPTY_SLOT_KEY};
+    std::atomic<uint32_t> users{0};
+
+    // number of parts plus the finish-message, which are still missing
+    std::atomic<uint32_t> missingEvents{0};
+    std::atomic<uint32_t> receivedParts{0};
+    std::atomic<uint32_t> pendingCredits{0};
+    std::atomic<bool> isFinished{false};
+    std::atomic<int64_t> lastActivity{0};
+    std::vector<std::atomic<uint64_t>> receivedBitmap;
+
+    // values of the message, which don't change while the slot is used, except blocker-id
+    // and response-flag, which are set by the finish-message before it is counted
+    MultiblockIO::MultiblockBuffer buffer;
+};
+
+class MultiblockTable
+{
+public:
+    MultiblockTable(const uint32_t numberOfSlots);
+    ~MultiblockTable();
+
+    MultiblockSlot* insert(const MultiblockIO::MultiblockBuffer &buffer);
+    MultiblockSlot* acquire(const uint64_t multiblockId);
+    void release(MultiblockSlot* slot);
+    bool remove(MultiblockSlot* slot,
+                const uint64_t multiblockId,
+                const bool isUser,
+                MultiblockIO::MultiblockBuffer &removedBuffer);
+
+    uint32_t getNumberOfSlots() const;
+    MultiblockSlot* getSlot(const uint32_t index);
+
+    static bool isValidId(const uint64_t multiblockId);
+    static int64_t getTimestamp();
+
+private:
+    MultiblockSlot* m_slots = nullptr;
+    uint32_t m_numberOfSlots = 0;
+    uint32_t m_numberOfBits = 0;
+    std::atomic<uint32_t> m_numberOfEntries{0};
+    std::mutex m_writeLock;
+
+    uint32_t getStartPosition(const uint64_t multiblockId) const;
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_MULTIBLOCK_TABLE_H
@@ -0,0 +1,100 @@
+/**
+ * @file       path_sender.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <path_sender.h>
+
+// interval in microseconds to check for the end of the thread, while there is no job
+#define PATH_SENDER_IDLE_INTERVAL 100000
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief constructor
+ */
+PathSender::PathSender()
+    : Kitsunemimi::Thread("PathSender") {}
+
+/**
+ * @brief destructor
+ */
+PathSender::~PathSender()
+{
+    // jobs, which were not processed anymore, are reported as failed, so no sender waits forever
+    std::lock_guard<std::mutex> guard(m_lock);
+    for(uint64_t i = 0; i < m_jobs.size(); i++) {
+        m_jobs[i].result.set_value(false);
+    }
+    m_jobs.clear();
+}
+
+/**
+ * @brief add a job, which sends parts of a multiblock-message over the connection of this sender
+ *
+ * @param task function, which sends the parts and returns false, if the send failed
+ *
+ * @return future, which provides the result of the task, after it was processed
+ */
+std::future<bool>
+PathSender::addJob(const std::function<bool()> &task)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    PathJob job;
+    job.task = task;
+    std::future<bool> result = job.result.get_future();
+    m_jobs.push_back(std::move(job));
+    m_jobCondition.notify_one();
+
+    return result;
+}
+
+/**
+ * @brief thread-loop to process the jobs in the order, in which they were added
+ */
+void
+PathSender::run()
+{
+    while(m_abort == false)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_jobCondition.wait_for(lock,
+                                std::chrono::microseconds(PATH_SENDER_IDLE_INTERVAL),
+                                [&] { return m_jobs.empty() == false || m_abort; });
+        if(m_jobs.empty()
+                || m_abort)
+        {
+            continue;
+        }
+
+        PathJob job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        lock.unlock();
+
+        job.result.set_value(job.task());
+    }
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,67 @@
+/**
+ * @file       path_sender.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_PATH_SENDER_H
+#define KITSUNEMIMI_SAKURA_NETWORK_PATH_SENDER_H
+
+#include <iostream>
+#include <deque>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <condition_variable>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class PathSender
+        : public Kitsunemimi::Thread
+{
+public:
+    PathSender();
+    ~PathSender();
+
+    std::future<bool> addJob(const std::function<bool()> &task);
+
+protected:
+    void run();
+
+private:
+    struct PathJob
+    {
+        std::function<bool()> task;
+        std::promise<bool> result;
+    };
+
+    std::mutex m_lock;
+    std::condition_variable m_jobCondition;
+    std::deque<PathJob> m_jobs;
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_PATH_SENDER_H
@@ -0,0 +1,121 @@
+/**
+ * @file       send_scheduler.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "send_scheduler.h"
+
+#include <message_definitions.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief constructor
+ */
+SendScheduler::SendScheduler() {}
+
+/**
+ * @brief destructor
+ */
+SendScheduler::~SendScheduler() {}
+
+/**
+ * @brief get the socket to write a small or control frame. These frames are preferred over
+ *        waiting bulk-frames, so they have to wait for at most one bulk-frame, which is currently
+ *        written.
+ */
+void
+SendScheduler::lock()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    m_waitingFrames++;
+    m_condition.wait(lock, [&] {
+        // a waiting bulk-frame gets its turn after too many small frames in a row
+        const bool bulkWaiting = m_nextTicket != m_servingTicket;
+        return m_busy == false
+               && (bulkWaiting == false || m_framesInRow < MAX_SMALL_FRAMES_IN_ROW);
+    });
+    m_waitingFrames--;
+
+    if(m_nextTicket != m_servingTicket) {
+        m_framesInRow++;
+    } else {
+        m_framesInRow = 0;
+    }
+    m_busy = true;
+}
+
+/**
+ * @brief get the socket to write a bulk-frame. Bulk-frames of concurrent transfers are written in
+ *        the order in which they were requested, so the transfers are interleaved part by part.
+ */
+void
+SendScheduler::lockBulk()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    const uint64_t ticket = m_nextTicket;
+    m_nextTicket++;
+    m_condition.wait(lock, [&] {
+        return m_busy == false
+               && ticket == m_servingTicket
+               && (m_waitingFrames == 0 || m_framesInRow >= MAX_SMALL_FRAMES_IN_ROW);
+    });
+
+    m_servingTicket++;
+    m_framesInRow = 0;
+    m_busy = true;
+}
+
+/**
+ * @brief get the socket to write a frame
+ *
+ * @param isBulk true, if the frame is big or a part of a multiblock-message
+ */
+void
+SendScheduler::lockFrame(const bool isBulk)
+{
+    if(isBulk) {
+        lockBulk();
+    } else {
+        lock();
+    }
+}
+
+/**
+ * @brief give the socket free for the next frame
+ */
+void
+SendScheduler::unlock()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_busy = false;
+    }
+
+    m_condition.notify_all();
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
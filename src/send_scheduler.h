@@ -0,0 +1,67 @@
+/**
+ * @file       send_scheduler.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_SEND_SCHEDULER_H
+#define KITSUNEMIMI_SAKURA_NETWORK_SEND_SCHEDULER_H
+
+#include <iostream>
+#include <mutex>
+#include <condition_variable>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class SendScheduler
+{
+public:
+    SendScheduler();
+    ~SendScheduler();
+
+    // small and control frames
+    void lock();
+    void unlock();
+
+    // big frames and parts of multiblock-messages
+    void lockBulk();
+    void lockFrame(const bool isBulk);
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_condition;
+    bool m_busy = false;
+
+    // small frames, which are waiting, and frames, which were sent in a row before a waiting
+    // bulk-frame
+    uint32_t m_waitingFrames = 0;
+    uint32_t m_framesInRow = 0;
+
+    // tickets to send bulk-frames of concurrent transfers in turns
+    uint64_t m_nextTicket = 0;
+    uint64_t m_servingTicket = 0;
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_SEND_SCHEDULER_H
@@ -30,6 +30,10 @@
 #include <messages_processing/singleblock_data_processing.h>
 
 #include <multiblock_io.h>
+#include <handler/flush_handler.h>
+#include <handler/send_queue.h>
+#include <buffer_pool.h>
+#include <send_scheduler.h>
 #include <message_definitions.h>
 
 #include <libKitsunemimiCommon/logger.h>
@@ -51,6 +55,37 @@ namespace Kitsunemimi
 namespace Sakura
 {
 
+/**
+ * @brief complete asynchronous request with an error, if its multiblock-message could not be
+ *        sent by the background-thread
+ */
+void
+asyncRequestSendCallback(void*,
+                         Session*,
+                         const uint64_t requestId,
+                         const bool success,
+                         const uint64_t,
+                         ErrorContainer &)
+{
+    if(success == false) {
+        SessionHandler::m_blockerHandler->releaseMessage(requestId, nullptr);
+    }
+}
+
+/**
+ * @brief give the response of an asynchronous request to the promise of its future
+ */
+void
+fulfillResponsePromise(void* target,
+                       Session*,
+                       const uint64_t,
+                       DataBuffer* response)
+{
+    std::promise<DataBuffer*>* promise = static_cast<std::promise<DataBuffer*>*>(target);
+    promise->set_value(response);
+    delete promise;
+}
+
 /**
  * @brief constructor
  *
@@ -59,7 +94,20 @@ namespace Sakura
 Session::Session(AbstractSocket* socket)
 {
     m_multiblockIo = new MultiblockIO(this);
+    m_framePool = new BufferPool();
+    m_sendScheduler = new SendScheduler();
+    m_sendBuffer = m_framePool->allocateBuffer(SMALL_FRAME_SIZE);
     m_socket = socket;
+    m_localCapabilities = SUPPORTED_CAPABILITIES;
+
+    // use the configured maximum single-message-size and the default-value until the handshake
+    // is finished
+    m_localMaxSingleSize = MAX_SINGLE_MESSAGE_SIZE;
+    if(SessionHandler::m_sessionHandler != nullptr) {
+        m_localMaxSingleSize = SessionHandler::m_sessionHandler->m_maxSingleSize;
+    }
+    m_maxSingleSize = std::min(m_localMaxSingleSize,
+                               static_cast<uint32_t>(MAX_SINGLE_MESSAGE_SIZE));
 
     initStatemachine();
 }
@@ -73,14 +121,52 @@ Session::~Session()
     m_initState = -1;
 
     SessionHandler::m_sessionHandler->removeSession(m_sessionId);
+
+    // no timeout of a message of the session should be processed anymore
+    if(SessionHandler::m_replyHandler != nullptr) {
+        SessionHandler::m_replyHandler->removeAllOfSession(this);
+    }
+
+    // drop queued asynchronous messages, which can not be sent anymore
+    if(SessionHandler::m_sendQueue != nullptr) {
+        SessionHandler::m_sendQueue->removeAllOfSession(this);
+    }
+
     ErrorContainer error;
+    disableCoalescing(error);
     closeSession(error, false);
+
+    // asynchronous requests of the session can not get a response anymore
+    if(SessionHandler::m_blockerHandler != nullptr) {
+        SessionHandler::m_blockerHandler->removeAllOfSession(this);
+    }
+
+    // wait for internal threads, which got the session from the session-map or which process a
+    // timeout of the session
+    while(m_activeUsers.load() > 0) {
+        usleep(100);
+    }
+
+    // delete all additional connections of the session
+    std::vector<Session*> paths;
+    m_pathLock.lock();
+    paths.swap(m_paths);
+    m_pathLock.unlock();
+    for(uint64_t i = 0; i < paths.size(); i++)
+    {
+        paths[i]->m_parentSession = nullptr;
+        delete paths[i];
+    }
+
     if(m_socket != nullptr)
     {
         m_socket->scheduleThreadForDeletion();
         m_socket = nullptr;
     }
     delete m_multiblockIo;
+    m_framePool->releaseBuffer(m_sendBuffer);
+    delete m_framePool;
+    delete m_sendScheduler;
 }
 
 /**
@@ -100,7 +186,7 @@ Session::sendStreamData(const void* data,
                         const bool replyExpected)
 {
     // check size
-    if(size > MAX_SINGLE_MESSAGE_SIZE) {
+    if(size > m_maxSingleSize) {
         return false;
     }
 
@@ -125,23 +211,45 @@ bool
 Session::sendNormalMessage(const void* data,
                            const uint64_t size,
                            ErrorContainer &error)
+{
+    uint64_t multiblockId = 0;
+    return sendNormalMessage(data, size, multiblockId, error);
+}
+
+/**
+ * @brief send normal message without response and get the id of the message, which can be used
+ *        by another thread to abort the transfer of a multiblock-message
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param multiblockId reference for the id of the message, which is written before anything is
+ *                     sent. In case of a multiblock-message this is the multiblock-id.
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+Session::sendNormalMessage(const void* data,
+                           const uint64_t size,
+                           uint64_t &multiblockId,
+                           ErrorContainer &error)
 {
     if(m_statemachine.isInState(SESSION_READY))
     {
-        uint64_t id = 0;
+        multiblockId = getRandId();
 
-        if(size <= MAX_SINGLE_MESSAGE_SIZE)
+        if(size <= m_maxSingleSize)
         {
             // send as single-block-message, if small enough
-            id = getRandId();
-            if(send_Data_SingleBlock(this, id, data, static_cast<uint32_t>(size), error) == false) {
+            const uint32_t singleSize = static_cast<uint32_t>(size);
+            if(send_Data_SingleBlock(this, multiblockId, data, singleSize, error) == false) {
                 return false;
             }
         }
         else
         {
             // if too big for one message, send as multi-block-message
-            if(m_multiblockIo->sendOutgoingData(data, size, error) == 0) {
+            if(m_multiblockIo->sendOutgoingData(data, size, error, 0, multiblockId) == 0) {
                 return false;
             }
         }
@@ -151,6 +259,46 @@ Session::sendNormalMessage(const void* data,
     return false;
 }
 
+/**
+ * @brief send a standalone-message as multiblock-message, which can be resumed after the
+ *        connection was lost. The other side keeps the parts, which were already received, for a
+ *        grace-period after the session was closed. After a new session to the other side with
+ *        the same session-identifier was created, the message can be send again with the old
+ *        multiblock-id and only the parts, which are missing on the other side, are send again.
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param multiblockId reference to the id of the transfer. If 0, a new id is created and written
+ *                     into the reference before anything is sent, so it can be used for a resume.
+ *                     If not 0, the transfer with this id is resumed.
+ * @param error reference for error-output
+ *
+ * @return false, if send failed or the other side doesn't support resumable transfers, else true
+ */
+bool
+Session::sendResumableMessage(const void* data,
+                              const uint64_t size,
+                              uint64_t &multiblockId,
+                              ErrorContainer &error)
+{
+    if(m_statemachine.isInState(SESSION_READY) == false) {
+        return false;
+    }
+
+    if(hasCapability(RESUMABLE_MULTIBLOCK) == false)
+    {
+        error.addMeesage("other side doesn't support resumable multiblock-messages");
+        return false;
+    }
+
+    const bool resume = multiblockId != 0;
+    if(resume == false) {
+        multiblockId = getRandId();
+    }
+
+    return m_multiblockIo->sendOutgoingData(data, size, error, 0, multiblockId, resume) != 0;
+}
+
 /**
  * @brief send a request and blocks until the other side had send a response-message or a timeout
  *        appeared
@@ -167,34 +315,251 @@ Session::sendRequest(const void* data,
                      const uint64_t size,
                      const uint64_t timeout,
                      ErrorContainer &error)
+{
+    uint64_t requestId = 0;
+    return sendRequest(data, size, std::chrono::seconds(timeout), requestId, error);
+}
+
+/**
+ * @brief send a request and blocks until the other side had send a response-message or a timeout
+ *        appeared
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param timeout time in seconds in which the response is expected
+ * @param requestId reference for the id of the request, which is written before anything is
+ *                  sent. In case of a multiblock-message this is also the multiblock-id, which
+ *                  can be used by another thread to abort the transfer.
+ * @param error reference for error-output
+ *
+ * @return content of the response message as data-buffer, or nullptr, if session is not active
+ */
+DataBuffer*
+Session::sendRequest(const void* data,
+                     const uint64_t size,
+                     const uint64_t timeout,
+                     uint64_t &requestId,
+                     ErrorContainer &error)
+{
+    return sendRequest(data, size, std::chrono::seconds(timeout), requestId, error);
+}
+
+/**
+ * @brief send a request and blocks until the other side had send a response-message or a timeout
+ *        appeared
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param timeout time in milliseconds in which the response is expected
+ * @param error reference for error-output
+ *
+ * @return content of the response message as data-buffer, or nullptr, if session is not active
+ */
+DataBuffer*
+Session::sendRequest(const void* data,
+                     const uint64_t size,
+                     const std::chrono::milliseconds timeout,
+                     ErrorContainer &error)
+{
+    uint64_t requestId = 0;
+    return sendRequest(data, size, timeout, requestId, error);
+}
+
+/**
+ * @brief send a request and blocks until the other side had send a response-message or a timeout
+ *        appeared
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param timeout time in milliseconds in which the response is expected
+ * @param requestId reference for the id of the request, which is written before anything is
+ *                  sent. In case of a multiblock-message this is also the multiblock-id, which
+ *                  can be used by another thread to abort the transfer.
+ * @param error reference for error-output
+ *
+ * @return content of the response message as data-buffer, or nullptr, if session is not active
+ */
+DataBuffer*
+Session::sendRequest(const void* data,
+                     const uint64_t size,
+                     const std::chrono::milliseconds timeout,
+                     uint64_t &requestId,
+                     ErrorContainer &error)
 {
     if(m_statemachine.isInState(SESSION_READY))
     {
-        uint64_t id = 0;
+        // register before sending, so a fast response can not get lost
+        const uint64_t id = getRandId();
+        requestId = id;
+        SessionHandler::m_blockerHandler->addBlockedMessage(id, timeout.count(), this);
 
-        if(size <= MAX_SINGLE_MESSAGE_SIZE)
+        bool ret = false;
+        if(size <= m_maxSingleSize)
         {
             // send as single-block-message, if small enough
-            id = getRandId();
-            if(send_Data_SingleBlock(this, id, data, static_cast<uint32_t>(size), error) == false) {
-                return nullptr;
-            }
+            ret = send_Data_SingleBlock(this, id, data, static_cast<uint32_t>(size), error);
         }
         else
         {
             // if too big for one message, send as multi-block-message
-            id = m_multiblockIo->sendOutgoingData(data, size, error);
-            if(id == 0) {
-                return nullptr;
-            }
+            ret = m_multiblockIo->sendOutgoingData(data, size, error, 0, id) != 0;
+        }
+
+        if(ret == false)
+        {
+            SessionHandler::m_blockerHandler->cancelMessage(id);
+            return nullptr;
         }
 
-        return SessionHandler::m_blockerHandler->blockMessage(id, timeout, this);
+        return SessionHandler::m_blockerHandler->waitForMessage(id);
     }
 
     return nullptr;
 }
 
+/**
+ * @brief send a request without blocking the calling thread. The response is given to the
+ *        callback, which is called by the thread of the socket or by the completion-executor of
+ *        the session. Requests, which are too big for a single-block-message, are sent by a
+ *        background-thread. The memory of the data must stay valid until the callback was called.
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param timeout time in seconds in which the response is expected
+ * @param receiver pointer, which is given to the callback
+ * @param processResponse callback, which gets the id of the request and the response as
+ *                        data-buffer, or nullptr in case of a timeout or if the request failed
+ * @param error reference for error-output
+ *
+ * @return id of the request, or 0, if the request could not be sent. In this case the callback
+ *         is not called.
+ */
+uint64_t
+Session::sendRequestAsync(const void* data,
+                          const uint64_t size,
+                          const uint64_t timeout,
+                          void* receiver,
+                          void (*processResponse)(void*, Session*, const uint64_t, DataBuffer*),
+                          ErrorContainer &error)
+{
+    return sendRequestAsync(data,
+                            size,
+                            std::chrono::seconds(timeout),
+                            receiver,
+                            processResponse,
+                            error);
+}
+
+/**
+ * @brief send a request without blocking the calling thread. The response is given to the
+ *        callback, which is called by the thread of the socket or by the completion-executor of
+ *        the session. Requests, which are too big for a single-block-message, are sent by a
+ *        background-thread. The memory of the data must stay valid until the callback was called.
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param timeout time in milliseconds in which the response is expected
+ * @param receiver pointer, which is given to the callback
+ * @param processResponse callback, which gets the id of the request and the response as
+ *                        data-buffer, or nullptr in case of a timeout or if the request failed
+ * @param error reference for error-output
+ *
+ * @return id of the request, or 0, if the request could not be sent. In this case the callback
+ *         is not called.
+ */
+uint64_t
+Session::sendRequestAsync(const void* data,
+                          const uint64_t size,
+                          const std::chrono::milliseconds timeout,
+                          void* receiver,
+                          void (*processResponse)(void*, Session*, const uint64_t, DataBuffer*),
+                          ErrorContainer &error)
+{
+    if(m_statemachine.isInState(SESSION_READY) == false
+            || processResponse == nullptr)
+    {
+        error.addMeesage("session is not ready to send requests");
+        return 0;
+    }
+
+    // register before sending, so a fast response can not get lost
+    const uint64_t id = getRandId();
+    SessionHandler::m_blockerHandler->addAsyncMessage(id,
+                                                      timeout.count(),
+                                                      this,
+                                                      receiver,
+                                                      processResponse);
+
+    bool ret = false;
+    if(size <= m_maxSingleSize)
+    {
+        // send as single-block-message, if small enough
+        ret = send_Data_SingleBlock(this, id, data, static_cast<uint32_t>(size), error);
+    }
+    else
+    {
+        // if too big for one message, send as multi-block-message by a background-thread
+        ret = queueMessage(data, size, 0, id, nullptr, &asyncRequestSendCallback, error) != 0;
+    }
+
+    if(ret == false)
+    {
+        SessionHandler::m_blockerHandler->cancelMessage(id);
+        return 0;
+    }
+
+    return id;
+}
+
+/**
+ * @brief send a request without blocking the calling thread and get the response by a future
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param timeout time in seconds in which the response is expected
+ * @param error reference for error-output
+ *
+ * @return future for the response as data-buffer, which is nullptr in case of a timeout or if
+ *         the request failed
+ */
+std::future<DataBuffer*>
+Session::sendRequestAsync(const void* data,
+                          const uint64_t size,
+                          const uint64_t timeout,
+                          ErrorContainer &error)
+{
+    return sendRequestAsync(data, size, std::chrono::seconds(timeout), error);
+}
+
+/**
+ * @brief send a request without blocking the calling thread and get the response by a future
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param timeout time in milliseconds in which the response is expected
+ * @param error reference for error-output
+ *
+ * @return future for the response as data-buffer, which is nullptr in case of a timeout or if
+ *         the request failed
+ */
+std::future<DataBuffer*>
+Session::sendRequestAsync(const void* data,
+                          const uint64_t size,
+                          const std::chrono::milliseconds timeout,
+                          ErrorContainer &error)
+{
+    std::promise<DataBuffer*>* promise = new std::promise<DataBuffer*>();
+    std::future<DataBuffer*> future = promise->get_future();
+
+    if(sendRequestAsync(data, size, timeout, promise, &fulfillResponsePromise, error) == 0)
+    {
+        promise->set_value(nullptr);
+        delete promise;
+    }
+
+    return future;
+}
+
 /**
  * @brief send response message as reponse for another requst
  *
@@ -213,7 +578,7 @@ Session::sendResponse(const void* data,
 {
     if(m_statemachine.isInState(SESSION_READY))
     {
-        if(size < MAX_SINGLE_MESSAGE_SIZE)
+        if(size <= m_maxSingleSize)
         {
             // send as single-block-message, if small enough
             const uint64_t singleblockId = getRandId();
@@ -232,7 +597,428 @@ Session::sendResponse(const void* data,
         }
     }
 
-    return 0;
+    return 0;
+}
+
+/**
+ * @brief abort an outgoing multiblock-message, which is currently sent by another thread. No
+ *        further parts are sent and the other side is told to drop the parts, which it has
+ *        already received. The sending call returns with an error.
+ *
+ * @param multiblockId id of the multiblock-message
+ *
+ * @return false, if no outgoing message with the id was found, else true
+ */
+bool
+Session::abortMultiblockMessage(const uint64_t multiblockId)
+{
+    return m_multiblockIo->abortOutgoingData(multiblockId);
+}
+
+/**
+ * @brief send normal message without response asynchronous. The call returns directly and the
+ *        message is sent by a background-thread. Messages of the same session are sent in the
+ *        order of the calls. The memory of the data must stay valid until the callback was called.
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param receiver pointer, which is given to the callback
+ * @param processSendResult callback, which is called by the background-thread after the message
+ *                          was sent or failed, with the send-id, the result, the number of sent
+ *                          bytes and the errors of the transfer. Can be nullptr.
+ * @param error reference for error-output
+ *
+ * @return send-id of the message, which is the multiblock-id in case of a multiblock-message and
+ *         can be used to abort the transfer, or 0, if the message could not be queued
+ */
+uint64_t
+Session::sendNormalMessageAsync(const void* data,
+                                const uint64_t size,
+                                void* receiver,
+                                void (*processSendResult)(void*,
+                                                          Session*,
+                                                          const uint64_t,
+                                                          const bool,
+                                                          const uint64_t,
+                                                          ErrorContainer &),
+                                ErrorContainer &error)
+{
+    return queueMessage(data, size, 0, getRandId(), receiver, processSendResult, error);
+}
+
+/**
+ * @brief send response message as reponse for another requst asynchronous. The call returns
+ *        directly and the message is sent by a background-thread. The memory of the data must
+ *        stay valid until the callback was called.
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param blockerId id to identify the response and map them to the related request
+ * @param receiver pointer, which is given to the callback
+ * @param processSendResult callback, which is called by the background-thread after the message
+ *                          was sent or failed. Can be nullptr.
+ * @param error reference for error-output
+ *
+ * @return send-id of the message, or 0, if the message could not be queued
+ */
+uint64_t
+Session::sendResponseAsync(const void* data,
+                           const uint64_t size,
+                           const uint64_t blockerId,
+                           void* receiver,
+                           void (*processSendResult)(void*,
+                                                     Session*,
+                                                     const uint64_t,
+                                                     const bool,
+                                                     const uint64_t,
+                                                     ErrorContainer &),
+                           ErrorContainer &error)
+{
+    if(blockerId == 0)
+    {
+        error.addMeesage("response without blocker-id");
+        return 0;
+    }
+
+    return queueMessage(data, size, blockerId, getRandId(), receiver, processSendResult, error);
+}
+
+/**
+ * @brief reserve a frame for a message, to write the payload directly into the memory, which is
+ *        later sent over the socket. Space for header, padding and footer is reserved around the
+ *        payload, so the message can be sent without any copy of the payload. The frame has to be
+ *        given back by one of the commit-methods or by releaseFrame.
+ *
+ * @param frame reference to the frame, which should be reserved
+ * @param size number of bytes of the payload
+ *
+ * @return false, if frame is already reserved, else true
+ */
+bool
+Session::reserveFrame(ReservedFrame &frame,
+                      const uint64_t size)
+{
+    if(frame.buffer != nullptr) {
+        return false;
+    }
+
+    DataBuffer* buffer = m_framePool->allocateBuffer(FRAME_HEADROOM + size + FRAME_TAILROOM);
+    if(buffer->data == nullptr)
+    {
+        m_framePool->releaseBuffer(buffer);
+        return false;
+    }
+
+    frame.buffer = buffer;
+    frame.payload = static_cast<uint8_t*>(buffer->data) + FRAME_HEADROOM;
+    frame.payloadSize = size;
+
+    return true;
+}
+
+/**
+ * @brief send the payload of a reserved frame as stream and release the frame
+ *
+ * @param frame reference to the reserved frame
+ * @param error reference for error-output
+ * @param replyExpected if true, the other side sends a reply-message to check timeouts
+ *
+ * @return false if session is NOT ready to send, send failed, or message is too big, else true
+ */
+bool
+Session::commitStreamData(ReservedFrame &frame,
+                          ErrorContainer &error,
+                          const bool replyExpected)
+{
+    bool result = false;
+
+    if(frame.buffer != nullptr
+            && frame.payloadSize <= m_maxSingleSize
+            && m_statemachine.isInState(SESSION_READY))
+    {
+        result = send_Data_Stream_InPlace(this,
+                                          frame.payload,
+                                          static_cast<uint32_t>(frame.payloadSize),
+                                          replyExpected,
+                                          error);
+    }
+
+    releaseFrame(frame);
+
+    return result;
+}
+
+/**
+ * @brief send the payload of a reserved frame as normal message without response and release
+ *        the frame
+ *
+ * @param frame reference to the reserved frame
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+Session::commitNormalMessage(ReservedFrame &frame,
+                             ErrorContainer &error)
+{
+    bool result = false;
+
+    if(frame.buffer != nullptr
+            && m_statemachine.isInState(SESSION_READY))
+    {
+        if(frame.payloadSize <= m_maxSingleSize)
+        {
+            // send as single-block-message, if small enough
+            result = send_Data_SingleBlock_InPlace(this,
+                                                   getRandId(),
+                                                   frame.payload,
+                                                   static_cast<uint32_t>(frame.payloadSize),
+                                                   error);
+        }
+        else
+        {
+            // if too big for one message, send as multi-block-message
+            result = m_multiblockIo->sendOutgoingData(frame.payload,
+                                                      frame.payloadSize,
+                                                      error) != 0;
+        }
+    }
+
+    releaseFrame(frame);
+
+    return result;
+}
+
+/**
+ * @brief send the payload of a reserved frame as request, release the frame and block until the
+ *        other side had send a response-message or a timeout appeared
+ *
+ * @param frame reference to the reserved frame
+ * @param timeout time in seconds in which the response is expected
+ * @param error reference for error-output
+ *
+ * @return content of the response message as data-buffer, or nullptr, if session is not active
+ */
+DataBuffer*
+Session::commitRequest(ReservedFrame &frame,
+                       const uint64_t timeout,
+                       ErrorContainer &error)
+{
+    return commitRequest(frame, std::chrono::seconds(timeout), error);
+}
+
+/**
+ * @brief send the payload of a reserved frame as request, release the frame and block until the
+ *        other side had send a response-message or a timeout appeared
+ *
+ * @param frame reference to the reserved frame
+ * @param timeout time in milliseconds in which the response is expected
+ * @param error reference for error-output
+ *
+ * @return content of the response message as data-buffer, or nullptr, if session is not active
+ */
+DataBuffer*
+Session::commitRequest(ReservedFrame &frame,
+                       const std::chrono::milliseconds timeout,
+                       ErrorContainer &error)
+{
+    uint64_t id = 0;
+
+    if(frame.buffer != nullptr
+            && m_statemachine.isInState(SESSION_READY))
+    {
+        // register before sending, so a fast response can not get lost
+        id = getRandId();
+        SessionHandler::m_blockerHandler->addBlockedMessage(id, timeout.count(), this);
+
+        bool ret = false;
+        if(frame.payloadSize <= m_maxSingleSize)
+        {
+            // send as single-block-message, if small enough
+            ret = send_Data_SingleBlock_InPlace(this,
+                                                id,
+                                                frame.payload,
+                                                static_cast<uint32_t>(frame.payloadSize),
+                                                error);
+        }
+        else
+        {
+            // if too big for one message, send as multi-block-message
+            ret = m_multiblockIo->sendOutgoingData(frame.payload,
+                                                   frame.payloadSize,
+                                                   error,
+                                                   0,
+                                                   id) != 0;
+        }
+
+        if(ret == false)
+        {
+            SessionHandler::m_blockerHandler->cancelMessage(id);
+            id = 0;
+        }
+    }
+
+    // release frame before blocking, because it is not necessary anymore
+    releaseFrame(frame);
+
+    if(id == 0) {
+        return nullptr;
+    }
+
+    return SessionHandler::m_blockerHandler->waitForMessage(id);
+}
+
+/**
+ * @brief send the payload of a reserved frame as reponse for another requst and release the frame
+ *
+ * @param frame reference to the reserved frame
+ * @param blockerId id to identify the response and map them to the related request
+ * @param error reference for error-output
+ *
+ * @return multiblock-id, or 0, if session is not active
+ */
+uint64_t
+Session::commitResponse(ReservedFrame &frame,
+                        const uint64_t blockerId,
+                        ErrorContainer &error)
+{
+    uint64_t id = 0;
+
+    if(frame.buffer != nullptr
+            && m_statemachine.isInState(SESSION_READY))
+    {
+        if(frame.payloadSize <= m_maxSingleSize)
+        {
+            // send as single-block-message, if small enough
+            id = getRandId();
+            send_Data_SingleBlock_InPlace(this,
+                                          id,
+                                          frame.payload,
+                                          static_cast<uint32_t>(frame.payloadSize),
+                                          error,
+                                          blockerId);
+        }
+        else
+        {
+            // if too big for one message, send as multi-block-message
+            id = m_multiblockIo->sendOutgoingData(frame.payload,
+                                                  frame.payloadSize,
+                                                  error,
+                                                  blockerId);
+        }
+    }
+
+    releaseFrame(frame);
+
+    return id;
+}
+
+/**
+ * @brief give a reserved frame back without sending it
+ *
+ * @param frame reference to the reserved frame
+ */
+void
+Session::releaseFrame(ReservedFrame &frame)
+{
+    if(frame.buffer == nullptr) {
+        return;
+    }
+
+    m_framePool->releaseBuffer(frame.buffer);
+
+    frame.buffer = nullptr;
+    frame.payload = nullptr;
+    frame.payloadSize = 0;
+}
+
+/**
+ * @brief enable coalescing of small messages. Messages up to 8 KiB are collected within a buffer
+ *        and written together with one write to the socket, when the threshold is reached, when
+ *        the oldest message within the buffer is older than the delay, or when flush is called.
+ *        Bigger messages and control-messages flush the buffer before they are sent, so the
+ *        order of all messages is not changed.
+ *
+ * @param threshold number of bytes, which trigger the write of the buffer
+ * @param maxDelay maximum time in microseconds, which a message stays within the buffer. The
+ *                 deadlines are checked at most every 100 microseconds.
+ *
+ * @return false, if a value is invalid, else true
+ */
+bool
+Session::enableCoalescing(const uint64_t threshold,
+                          const uint64_t maxDelay)
+{
+    if(threshold == 0
+            || threshold > MAX_SINGLE_MESSAGE_SIZE_LIMIT
+            || maxDelay == 0)
+    {
+        return false;
+    }
+
+    DataBuffer* newBuffer = m_framePool->allocateBuffer(threshold + SMALL_FRAME_SIZE);
+    if(newBuffer->data == nullptr)
+    {
+        m_framePool->releaseBuffer(newBuffer);
+        return false;
+    }
+
+    // replace old buffer, if coalescing was already enabled
+    {
+        std::lock_guard<SendScheduler> guard(*m_sendScheduler);
+
+        flushCoalescedFrames(sessionError);
+        m_framePool->releaseBuffer(m_coalescingBuffer);
+
+        m_coalescingBuffer = newBuffer;
+        m_coalescingThreshold = threshold;
+        m_coalescingDelay = maxDelay;
+    }
+
+    SessionHandler::m_flushHandler->removeSession(this);
+    SessionHandler::m_flushHandler->addSession(this);
+
+    return true;
+}
+
+/**
+ * @brief disable coalescing and write all buffered messages to the socket
+ *
+ * @param error reference for error-output
+ *
+ * @return false, if the write of the buffered messages failed, else true
+ */
+bool
+Session::disableCoalescing(ErrorContainer &error)
+{
+    if(SessionHandler::m_flushHandler != nullptr) {
+        SessionHandler::m_flushHandler->removeSession(this);
+    }
+
+    std::lock_guard<SendScheduler> guard(*m_sendScheduler);
+
+    const bool ret = flushCoalescedFrames(error);
+
+    m_framePool->releaseBuffer(m_coalescingBuffer);
+    m_coalescingBuffer = nullptr;
+    m_coalescingThreshold = 0;
+    m_coalescingDelay = 0;
+
+    return ret;
+}
+
+/**
+ * @brief write all messages, which are buffered for coalescing, to the socket
+ *
+ * @param error reference for error-output
+ *
+ * @return false, if write failed, else true
+ */
+bool
+Session::flush(ErrorContainer &error)
+{
+    std::lock_guard<SendScheduler> guard(*m_sendScheduler);
+    return flushCoalescedFrames(error);
 }
 
 /**
@@ -257,6 +1043,71 @@ Session::setRequestCallback(void* receiver,
     m_processRequestData = processRequest;
 }
 
+/**
+ * @brief set callback for requests, which gets only a view on the payload instead of a copy
+ *        within a new data-buffer. The view is only valid while the callback is running, so the
+ *        data have to be copied with detachData, if they are necessary after the callback. If set,
+ *        this callback is used instead of the callback of setRequestCallback. Set the callback to
+ *        nullptr to switch back.
+ */
+void
+Session::setRequestViewCallback(void* receiver,
+                                void (*processRequestView)(void*,
+                                                           Session*,
+                                                           const uint64_t,
+                                                           const void*,
+                                                           const uint64_t))
+{
+    m_requestViewReceiver = receiver;
+    m_processRequestView = processRequestView;
+}
+
+/**
+ * @brief set callback, which is asked for the memory of an incoming multiblock-message, when the
+ *        first part of the message arrives. It gets the multiblock-id, the total size of the
+ *        message and if the message is a response and has to return a data-buffer with at least
+ *        the total size or nullptr to use an internal buffer. The parts are written directly
+ *        into the returned buffer, which is handed back with the complete message. The buffer
+ *        stays owned by the application and is never released by the session. Set the callback
+ *        to nullptr to switch back.
+ */
+void
+Session::setMultiblockAllocationCallback(void* receiver,
+                                         DataBuffer* (*allocateMultiblock)(void*,
+                                                                           Session*,
+                                                                           const uint64_t,
+                                                                           const uint64_t,
+                                                                           const bool))
+{
+    m_allocationReceiver = receiver;
+    m_allocateMultiblock = allocateMultiblock;
+}
+
+/**
+ * @brief set callback for a streaming receive of multiblock-messages. If set, incoming
+ *        multiblock-messages, which are not responses, are not buffered, but each part is given
+ *        to the callback directly out of the receive-buffer, when it arrives. The callback gets
+ *        the multiblock-id, the offset of the part within the message, a view on the part, its
+ *        size and a flag, which is true for the last part of the message. The view is only valid
+ *        while the callback is running. The parts of one message can arrive in any order, if
+ *        the session has additional connections, but the callbacks are never running in
+ *        parallel and the last one is always the one with the last-flag. Set the callback to
+ *        nullptr to switch back.
+ */
+void
+Session::setMultiblockPartCallback(void* receiver,
+                                   void (*processMultiblockPart)(void*,
+                                                                 Session*,
+                                                                 const uint64_t,
+                                                                 const uint64_t,
+                                                                 const void*,
+                                                                 const uint64_t,
+                                                                 const bool))
+{
+    m_multiblockPartReceiver = receiver;
+    m_processMultiblockPart = processMultiblockPart;
+}
+
 /**
  * @brief set callback for errors
  */
@@ -266,6 +1117,23 @@ Session::setErrorCallback(void (*processError)(Session*, const uint8_t, const st
     m_processError = processError;
 }
 
+/**
+ * @brief set an executor for the callbacks of asynchronous requests. Without executor the
+ *        callbacks are called directly by the thread of the socket, which received the response.
+ *        The executor gets the task-function and its argument and has to call the task exactly
+ *        once before the session is deleted.
+ *
+ * @param executor pointer, which is given to the execute-function
+ * @param executeCompletion function to hand over a completion to the executor
+ */
+void
+Session::setCompletionExecutor(void* executor,
+                               void (*executeCompletion)(void*, void (*)(void*), void*))
+{
+    m_completionExecutor = executor;
+    m_executeCompletion = executeCompletion;
+}
+
 /**
  * @brief close the session inclusive multiblock-messages, statemachine, message to the other side
  *        and close the socket
@@ -281,7 +1149,13 @@ Session::closeSession(ErrorContainer &error,
     LOG_DEBUG("close session with id " + std::to_string(m_sessionId));
     if(m_statemachine.isInState(SESSION_READY))
     {
-        SessionHandler::m_replyHandler->removeAllOfSession(m_sessionId);
+        // close additional connections together with the session
+        const std::vector<Session*> paths = getPaths();
+        for(uint64_t i = 1; i < paths.size(); i++) {
+            paths[i]->closeSession(error, false);
+        }
+
+        SessionHandler::m_replyHandler->removeAllOfSession(this);
         m_multiblockIo->removeMultiblockBuffer(0);
         if(replyExpected)
         {
@@ -309,14 +1183,15 @@ Session::sessionId() const
 }
 
 /**
- * @brief get maximum stream-message size
+ * @brief get maximum size of single-block- and stream-messages, which was negotiated while the
+ *        session-handshake
  *
- * @return maximum stream-message size
+ * @return maximum single-message size
  */
 uint32_t
 Session::getMaximumSingleSize() const
 {
-    return MAX_SINGLE_MESSAGE_SIZE;
+    return m_maxSingleSize;
 }
 
 /**
@@ -333,6 +1208,61 @@ Session::isClientSide() const
     return m_socket->isClientSide();
 }
 
+/**
+ * @brief get capabilities, which are supported by both sides of the session
+ *
+ * @return bitmap with the negotiated capabilities
+ */
+uint64_t
+Session::getCapabilities() const
+{
+    return m_capabilities;
+}
+
+/**
+ * @brief check if a capability is supported by both sides of the session
+ *
+ * @param capability capability to check
+ *
+ * @return true, if the capability was negotiated while the session-handshake, else false
+ */
+bool
+Session::hasCapability(const uint64_t capability) const
+{
+    return (m_capabilities & capability) == capability;
+}
+
+/**
+ * @brief copy data of a view, which was given to the request-view-callback, into a new buffer to
+ *        keep the data after the callback
+ *
+ * @param data pointer to the data of the view
+ * @param size size of the view
+ *
+ * @return new data-buffer with a copy of the data, which has to be released by the caller with
+ *         the releaseBuffer-method of the session-controller
+ */
+DataBuffer*
+Session::detachData(const void* data,
+                    const uint64_t size)
+{
+    DataBuffer* buffer = SessionHandler::m_sessionHandler->allocateBuffer(size);
+    addData_DataBuffer(*buffer, data, size);
+
+    return buffer;
+}
+
+/**
+ * @brief get the number of connections, which are used for multiblock-messages
+ *
+ * @return 1 + number of additional connections, which are ready
+ */
+uint32_t
+Session::getNumberOfPaths()
+{
+    return static_cast<uint32_t>(getPaths().size());
+}
+
 /**
  * @brief create the network connection of the session
  *
@@ -402,7 +1332,10 @@ Session::makeSessionReady(const uint32_t sessionId,
         m_sessionId = sessionId;
         m_sessionIdentifier = sessionIdentifier;
 
-        m_processCreateSession(this, m_sessionIdentifier);
+        // additional connections are internal and not visible for the user
+        if(m_parentSession == nullptr) {
+            m_processCreateSession(this, m_sessionIdentifier);
+        }
 
         // release blocked session on client-side
         m_initState = 1;
@@ -433,7 +1366,12 @@ Session::endSession(ErrorContainer &error)
     // try to stop the session
     if(m_statemachine.goToNextState(STOP_SESSION))
     {
-        m_processCloseSession(this, m_sessionIdentifier);
+        // senders of multiblock-messages don't have to wait for the other side anymore
+        m_multiblockIo->wakeUpSenders();
+
+        if(m_parentSession == nullptr) {
+            m_processCloseSession(this, m_sessionIdentifier);
+        }
         SessionHandler::m_sessionHandler->removeSession(m_sessionId);
         return disconnectSession(error);
     }
@@ -458,6 +1396,9 @@ Session::disconnectSession(ErrorContainer &error)
             return false;
         }
 
+        // write messages, which are still buffered for coalescing
+        flush(error);
+
         if(m_socket->closeSocket() == false)
         {
             error.addMeesage("Failed to close session");
@@ -500,7 +1441,267 @@ Session::sendMessage(const CommonMessageHeader &header,
                                                    this);
     }
 
-    return m_socket->sendMessage(data, size, error);
+    std::lock_guard<SendScheduler> guard(*m_sendScheduler);
+    return flushCoalescedFrames(error)
+           && m_socket->sendMessage(data, size, error);
+}
+
+/**
+ * @brief send a variable-length message, which consists of a header, a payload, a padding to a
+ *        multiple of 8 and the footer. The totalMessageSize and payloadSize within the header
+ *        have to be already set by the caller. Small messages are build within the send-buffer of
+ *        the session and sent with a single write. For bigger messages header, payload and padding
+ *        with footer are written one after another directly to the socket, to avoid a copy of the
+ *        payload.
+ *
+ * @param commonHeader reference to the common header of the message
+ * @param header pointer to the complete header of the message
+ * @param headerSize size of the complete header
+ * @param payload pointer to the payload
+ * @param payloadSize number of bytes of the payload
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+Session::sendFrame(const CommonMessageHeader &commonHeader,
+                   const void* header,
+                   const uint64_t headerSize,
+                   const void* payload,
+                   const uint64_t payloadSize,
+                   ErrorContainer &error)
+{
+    if(m_socket == nullptr) {
+        return false;
+    }
+
+    const uint32_t totalMessageSize = calcMessageSize(headerSize, payloadSize);
+    const uint64_t tailSize = totalMessageSize - headerSize - payloadSize;
+    const CommonMessageFooter end;
+
+    // big frames and parts of multiblock-messages are interleaved with other frames by the
+    // send-scheduler, so small frames don't have to wait until a whole transfer is written
+    const bool isBulk = totalMessageSize > SMALL_FRAME_SIZE
+                        || (commonHeader.type == MULTIBLOCK_DATA_TYPE
+                            && commonHeader.subType == DATA_MULTI_STATIC_SUBTYPE);
+
+    if(commonHeader.flags & 0x1)
+    {
+        SessionHandler::m_replyHandler->addMessage(commonHeader.type,
+                                                   commonHeader.sessionId,
+                                                   commonHeader.messageId,
+                                                   this);
+    }
+
+    // build small messages within the send-buffer of the session to send them with only one
+    // write. The buffer is protected by the send-lock, so it can be reused for each message.
+    if(totalMessageSize <= SMALL_FRAME_SIZE
+            && m_sendBuffer->data != nullptr)
+    {
+        m_sendScheduler->lockFrame(isBulk);
+        std::lock_guard<SendScheduler> guard(*m_sendScheduler, std::adopt_lock);
+
+        // build message directly within the coalescing-buffer, if coalescing is enabled
+        uint8_t* messageBuffer = reserveCoalescedFrame(totalMessageSize);
+        const bool coalesced = messageBuffer != nullptr;
+        if(coalesced == false) {
+            messageBuffer = static_cast<uint8_t*>(m_sendBuffer->data);
+        }
+
+        memcpy(&messageBuffer[0], header, headerSize);
+        if(payloadSize > 0) {
+            memcpy(&messageBuffer[headerSize], payload, payloadSize);
+        }
+        memset(&messageBuffer[headerSize + payloadSize],
+               0,
+               tailSize - sizeof(CommonMessageFooter));
+        memcpy(&messageBuffer[totalMessageSize - sizeof(CommonMessageFooter)],
+               &end,
+               sizeof(CommonMessageFooter));
+
+        if(coalesced) {
+            return finishCoalescedFrame(error);
+        }
+
+        return m_socket->sendMessage(messageBuffer, totalMessageSize, error);
+    }
+
+    // padding and footer
+    uint8_t tail[8 + sizeof(CommonMessageFooter)];
+    memset(tail, 0, sizeof(tail));
+    memcpy(&tail[tailSize - sizeof(CommonMessageFooter)], &end, sizeof(CommonMessageFooter));
+
+    // the lock prevents, that other messages are written between the parts of this message
+    m_sendScheduler->lockFrame(isBulk);
+    std::lock_guard<SendScheduler> guard(*m_sendScheduler, std::adopt_lock);
+    return flushCoalescedFrames(error)
+           && m_socket->sendMessage(header, headerSize, error)
+           && m_socket->sendMessage(payload, payloadSize, error)
+           && m_socket->sendMessage(tail, tailSize, error);
+}
+
+/**
+ * @brief send a variable-length message, which payload is located within a reserved frame. The
+ *        header is written directly before the payload and padding and footer directly behind
+ *        the payload, so the complete message can be sent with a single write and without copy.
+ *        The caller has to make sure, that there is at least FRAME_HEADROOM bytes before and
+ *        FRAME_TAILROOM bytes behind the payload.
+ *
+ * @param commonHeader reference to the common header of the message
+ * @param header pointer to the complete header of the message
+ * @param headerSize size of the complete header
+ * @param payload pointer to the payload within the reserved frame
+ * @param payloadSize number of bytes of the payload
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+Session::sendFrameInPlace(const CommonMessageHeader &commonHeader,
+                          const void* header,
+                          const uint64_t headerSize,
+                          void* payload,
+                          const uint64_t payloadSize,
+                          ErrorContainer &error)
+{
+    if(m_socket == nullptr
+            || headerSize > FRAME_HEADROOM)
+    {
+        return false;
+    }
+
+    const uint32_t totalMessageSize = calcMessageSize(headerSize, payloadSize);
+    const uint64_t paddingSize = totalMessageSize
+                                 - headerSize
+                                 - payloadSize
+                                 - sizeof(CommonMessageFooter);
+    const CommonMessageFooter end;
+
+    // write header, padding and footer around the payload
+    uint8_t* frameStart = static_cast<uint8_t*>(payload) - headerSize;
+    uint8_t* frameTail = static_cast<uint8_t*>(payload) + payloadSize;
+    memcpy(frameStart, header, headerSize);
+    memset(frameTail, 0, paddingSize);
+    memcpy(&frameTail[paddingSize], &end, sizeof(CommonMessageFooter));
+
+    if(commonHeader.flags & 0x1)
+    {
+        SessionHandler::m_replyHandler->addMessage(commonHeader.type,
+                                                   commonHeader.sessionId,
+                                                   commonHeader.messageId,
+                                                   this);
+    }
+
+    m_sendScheduler->lockFrame(totalMessageSize > SMALL_FRAME_SIZE);
+    std::lock_guard<SendScheduler> guard(*m_sendScheduler, std::adopt_lock);
+
+    // small messages are copied into the coalescing-buffer, if coalescing is enabled
+    uint8_t* coalescedFrame = reserveCoalescedFrame(totalMessageSize);
+    if(coalescedFrame != nullptr)
+    {
+        memcpy(coalescedFrame, frameStart, totalMessageSize);
+        return finishCoalescedFrame(error);
+    }
+
+    return flushCoalescedFrames(error)
+           && m_socket->sendMessage(frameStart, totalMessageSize, error);
+}
+
+/**
+ * @brief get space for a small message within the coalescing-buffer. The send-lock has to be
+ *        held by the caller.
+ *
+ * @param size total size of the message
+ *
+ * @return pointer to the space for the message, or nullptr, if coalescing is disabled or the
+ *         message is too big
+ */
+uint8_t*
+Session::reserveCoalescedFrame(const uint64_t size)
+{
+    if(m_coalescingBuffer == nullptr
+            || size > SMALL_FRAME_SIZE)
+    {
+        return nullptr;
+    }
+
+    // the deadline starts with the first message within the buffer
+    if(m_coalescingBuffer->usedBufferSize == 0)
+    {
+        m_coalescingDeadline = std::chrono::steady_clock::now()
+                               + std::chrono::microseconds(m_coalescingDelay);
+    }
+
+    uint8_t* frame = static_cast<uint8_t*>(m_coalescingBuffer->data)
+                     + m_coalescingBuffer->usedBufferSize;
+    m_coalescingBuffer->usedBufferSize += size;
+
+    return frame;
+}
+
+/**
+ * @brief finish a message within the coalescing-buffer and flush the buffer, if the threshold is
+ *        reached. The send-lock has to be held by the caller.
+ *
+ * @param error reference for error-output
+ *
+ * @return false, if flush failed, else true
+ */
+bool
+Session::finishCoalescedFrame(ErrorContainer &error)
+{
+    if(m_coalescingBuffer->usedBufferSize >= m_coalescingThreshold) {
+        return flushCoalescedFrames(error);
+    }
+
+    return true;
+}
+
+/**
+ * @brief write all messages of the coalescing-buffer with one write to the socket. The send-lock
+ *        has to be held by the caller.
+ *
+ * @param error reference for error-output
+ *
+ * @return false, if write failed, else true
+ */
+bool
+Session::flushCoalescedFrames(ErrorContainer &error)
+{
+    if(m_coalescingBuffer == nullptr
+            || m_coalescingBuffer->usedBufferSize == 0)
+    {
+        return true;
+    }
+
+    const uint64_t size = m_coalescingBuffer->usedBufferSize;
+    m_coalescingBuffer->usedBufferSize = 0;
+
+    if(m_socket == nullptr) {
+        return false;
+    }
+
+    return m_socket->sendMessage(m_coalescingBuffer->data, size, error);
+}
+
+/**
+ * @brief flush the coalescing-buffer, if the deadline of the oldest message within the buffer is
+ *        reached. This is called by the flush-handler.
+ */
+void
+Session::flushExpiredFrames()
+{
+    std::lock_guard<SendScheduler> guard(*m_sendScheduler);
+
+    if(m_coalescingBuffer == nullptr
+            || m_coalescingBuffer->usedBufferSize == 0)
+    {
+        return;
+    }
+
+    if(std::chrono::steady_clock::now() >= m_coalescingDeadline) {
+        flushCoalescedFrames(sessionError);
+    }
 }
 
 /**
@@ -522,6 +1723,169 @@ Session::sendHeartbeat()
     return false;
 }
 
+/**
+ * @brief check if the session is ready for data-transfers
+ *
+ * @return true, if session is ready, else false
+ */
+bool
+Session::isReady()
+{
+    return m_statemachine.isInState(SESSION_READY);
+}
+
+/**
+ * @brief get the size of the parts of multiblock-messages. Older versions of the other side
+ *        always split multiblock-messages into parts of the default single-message-size, no
+ *        matter which maximum size is configured on this side.
+ *
+ * @return size of each part of a multiblock-message, except the last one
+ */
+uint32_t
+Session::getMultiblockPartSize() const
+{
+    if(hasCapability(NEGOTIATED_SINGLE_SIZE)) {
+        return m_maxSingleSize;
+    }
+
+    return MAX_SINGLE_MESSAGE_SIZE;
+}
+
+/**
+ * @brief add another session as additional connection to this session. Parts of
+ *        multiblock-messages are spread over all connections. The session takes the ownership
+ *        of the added session.
+ *
+ * @param path session, which should be added as additional connection
+ */
+void
+Session::addPath(Session* path)
+{
+    std::lock_guard<std::mutex> guard(m_pathLock);
+    m_paths.push_back(path);
+}
+
+/**
+ * @brief get all connections, which can be used for the parts of multiblock-messages
+ *
+ * @return list with this session at first and all ready additional connections
+ */
+std::vector<Session*>
+Session::getPaths()
+{
+    std::vector<Session*> result;
+    result.push_back(this);
+
+    std::lock_guard<std::mutex> guard(m_pathLock);
+    for(uint64_t i = 0; i < m_paths.size(); i++)
+    {
+        if(m_paths[i]->isReady()) {
+            result.push_back(m_paths[i]);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief add a message to the queue of the send-threads
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param blockerId blocker-id in case that the message is a response, else 0
+ * @param sendId id of the message
+ * @param receiver pointer, which is given to the callback
+ * @param processSendResult callback for the result of the transfer
+ * @param error reference for error-output
+ *
+ * @return send-id of the message, or 0, if the message could not be queued
+ */
+uint64_t
+Session::queueMessage(const void* data,
+                      const uint64_t size,
+                      const uint64_t blockerId,
+                      const uint64_t sendId,
+                      void* receiver,
+                      void (*processSendResult)(void*,
+                                                Session*,
+                                                const uint64_t,
+                                                const bool,
+                                                const uint64_t,
+                                                ErrorContainer &),
+                      ErrorContainer &error)
+{
+    if(m_statemachine.isInState(SESSION_READY) == false)
+    {
+        error.addMeesage("session is not ready to send messages");
+        return 0;
+    }
+
+    if(SessionHandler::m_sendQueue == nullptr)
+    {
+        error.addMeesage("no send-thread available");
+        return 0;
+    }
+
+    SendQueue::SendJob job;
+    job.session = this;
+    job.data = data;
+    job.size = size;
+    job.sendId = sendId;
+    job.blockerId = blockerId;
+    job.receiver = receiver;
+    job.processSendResult = processSendResult;
+
+    // messages of the session are sent one after another to keep their order, but by any
+    // send-thread, which is free
+    if(SessionHandler::m_sendQueue->addJob(job) == false)
+    {
+        error.addMeesage("send-thread is already closed");
+        return 0;
+    }
+
+    return job.sendId;
+}
+
+/**
+ * @brief send a message of the queue of the send-thread with the id, which was given back to the
+ *        caller while queuing
+ *
+ * @param data data-pointer
+ * @param size number of bytes
+ * @param sendId id of the message
+ * @param blockerId blocker-id in case that the message is a response, else 0
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+Session::sendQueuedMessage(const void* data,
+                           const uint64_t size,
+                           const uint64_t sendId,
+                           const uint64_t blockerId,
+                           ErrorContainer &error)
+{
+    if(m_statemachine.isInState(SESSION_READY) == false)
+    {
+        error.addMeesage("session was closed before the message was sent");
+        return false;
+    }
+
+    if(size <= m_maxSingleSize)
+    {
+        // send as single-block-message, if small enough
+        return send_Data_SingleBlock(this,
+                                     sendId,
+                                     data,
+                                     static_cast<uint32_t>(size),
+                                     error,
+                                     blockerId);
+    }
+
+    // if too big for one message, send as multi-block-message
+    return m_multiblockIo->sendOutgoingData(data, size, error, blockerId, sendId) != 0;
+}
+
 /**
  * @brief init the statemachine
  */
@@ -250,6 +250,128 @@ SessionController::cloesAllServers()
 
 //==================================================================================================
 
+/**
+ * @brief set the maximum size of single-block- and stream-messages, which is offered to the
+ *        other side within the handshake of new sessions. The smaller value of both sides is used
+ *        for the session. Bigger messages are splitted into multiple parts of this size. The
+ *        value is limited to 1 MiB, so each message fits into the receive-buffer of the sockets.
+ *
+ * @param maxSingleSize new maximum size in bytes
+ *
+ * @return false, if the value is out of the valid range, else true
+ */
+bool
+SessionController::setMaximumSingleSize(const uint32_t maxSingleSize)
+{
+    if(maxSingleSize < MIN_SINGLE_MESSAGE_SIZE
+            || maxSingleSize > MAX_SINGLE_MESSAGE_SIZE_LIMIT)
+    {
+        return false;
+    }
+
+    SessionHandler::m_sessionHandler->m_maxSingleSize = maxSingleSize;
+
+    return true;
+}
+
+/**
+ * @brief set the limits for incomplete incoming multiblock-messages. A new multiblock-message,
+ *        which would exceed the memory-limit of its session or of all sessions together, is
+ *        rejected and the other side gets an error-message. Incomplete messages, which don't get
+ *        new parts within the idle-timeout, are removed.
+ *
+ * @param maxSessionMemory maximum number of bytes for the incomplete messages of one session
+ * @param maxTotalMemory maximum number of bytes for the incomplete messages of all sessions
+ * @param idleTimeout time in seconds, after which an incomplete message without new parts is
+ *                    removed
+ *
+ * @return false, if a value is 0 or the session-limit is bigger than the total limit, else true
+ */
+bool
+SessionController::setMultiblockLimits(const uint64_t maxSessionMemory,
+                                       const uint64_t maxTotalMemory,
+                                       const uint32_t idleTimeout)
+{
+    if(maxSessionMemory == 0
+            || maxTotalMemory == 0
+            || idleTimeout == 0
+            || maxSessionMemory > maxTotalMemory)
+    {
+        return false;
+    }
+
+    SessionHandler::m_sessionHandler->m_maxSessionMultiblockMemory = maxSessionMemory;
+    SessionHandler::m_sessionHandler->m_maxTotalMultiblockMemory = maxTotalMemory;
+    SessionHandler::m_sessionHandler->m_multiblockIdleTimeout = idleTimeout;
+
+    return true;
+}
+
+/**
+ * @brief set the time, in which the other side has to reply to a message, which expects a reply
+ *        (session-, heartbeat- and stream-messages with reply-flag), before a timeout is given to
+ *        the error-callback. The timeout of requests is given by the request-methods of the
+ *        session.
+ *
+ * @param messageType type of the message like defined in the protocol (1 = session,
+ *                    2 = heartbeat, 4 = stream-data, 5 = singleblock-data, 6 = multiblock-data)
+ * @param timeout time in milliseconds
+ *
+ * @return false, if the message-type is unknown or the timeout is 0, else true
+ */
+bool
+SessionController::setReplyTimeout(const uint8_t messageType,
+                                   const uint32_t timeout)
+{
+    if(messageType < SESSION_TYPE
+            || messageType > MULTIBLOCK_DATA_TYPE
+            || messageType == ERROR_TYPE
+            || timeout == 0)
+    {
+        return false;
+    }
+
+    SessionHandler::m_replyHandler->setTimeout(messageType, timeout);
+
+    return true;
+}
+
+/**
+ * @brief set allocator for the data-buffers of incoming messages. This has to be done before the
+ *        first server or session is created, because all buffers have to be released by the same
+ *        allocator, which had created them. The allocator is not deleted by the controller and
+ *        must exist as long as the controller exist.
+ *
+ * @param allocator new allocator or nullptr to use the internal buffer-pool
+ *
+ * @return false, if a server or session already exists, else true
+ */
+bool
+SessionController::setBufferAllocator(BufferAllocator* allocator)
+{
+    return SessionHandler::m_sessionHandler->setBufferAllocator(allocator);
+}
+
+/**
+ * @brief give a data-buffer of an incoming message back to the buffer-allocator instead of delete
+ *        it, so it can be reused for the next incoming message
+ *
+ * @param buffer data-buffer, which was given by a request-callback or as response of a request
+ */
+void
+SessionController::releaseBuffer(DataBuffer* buffer)
+{
+    if(SessionHandler::m_sessionHandler == nullptr)
+    {
+        delete buffer;
+        return;
+    }
+
+    SessionHandler::m_sessionHandler->releaseBuffer(buffer);
+}
+
+//==================================================================================================
+
 /**
  * @brief start new unix-domain-socket
  *
@@ -325,21 +447,143 @@ SessionController::startTlsTcpSession(const std::string &address,
     return startSession(tlsTcpTemplSocket, sessionIdentifier, error);
 }
 
+/**
+ * @brief add a new unix-domain-socket as additional connection to a session
+ *
+ * @param session session, which should be extended
+ * @param socketFile socket-file-path, where the unix-domain-socket server is listening
+ *
+ * @return true, if connection was successfully created and added, else false
+ */
+bool
+SessionController::addUnixDomainPath(Session* session,
+                                     const std::string &socketFile,
+                                     const std::string &threadName,
+                                     ErrorContainer &error)
+{
+    UnixDomainSocket udsSocket(socketFile);
+    TemplateSocket<UnixDomainSocket>* unixDomainSocket = nullptr;
+    unixDomainSocket = new TemplateSocket<UnixDomainSocket>(std::move(udsSocket),
+                                                                              threadName);
+
+    return addPath(session, unixDomainSocket, error);
+}
+
+/**
+ * @brief add a new tcp-connection as additional connection to a session
+ *
+ * @param session session, which should be extended
+ * @param address ip-address of the server
+ * @param port port where the server is listening
+ *
+ * @return true, if connection was successfully created and added, else false
+ */
+bool
+SessionController::addTcpPath(Session* session,
+                              const std::string &address,
+                              const uint16_t port,
+                              const std::string &threadName,
+                              ErrorContainer &error)
+{
+    TcpSocket tcpSocket(address, port);
+    TemplateSocket<TcpSocket>* tcpTemplateSocket = nullptr;
+    tcpTemplateSocket = new TemplateSocket<TcpSocket>(std::move(tcpSocket),
+                                                                        threadName);
+    return addPath(session, tcpTemplateSocket, error);
+}
+
+/**
+ * @brief add a new tls-tcp-connection as additional connection to a session
+ *
+ * @param session session, which should be extended
+ * @param address ip-address of the server
+ * @param port port where the server is listening
+ * @param certFile path to the certificate-file
+ * @param keyFile path to the key-file
+ *
+ * @return true, if connection was successfully created and added, else false
+ */
+bool
+SessionController::addTlsTcpPath(Session* session,
+                                 const std::string &address,
+                                 const uint16_t port,
+                                 const std::string &certFile,
+                                 const std::string &keyFile,
+                                 const std::string &threadName,
+                                 ErrorContainer &error)
+{
+    TcpSocket tcpSocket(address, port);
+    TlsTcpSocket tlsTcpSocket(std::move(tcpSocket),
+                                       certFile,
+                                       keyFile);
+    TemplateSocket<TlsTcpSocket>* tlsTcpTemplSocket = nullptr;
+    tlsTcpTemplSocket = new TemplateSocket<TlsTcpSocket>(std::move(tlsTcpSocket),
+                                                                           threadName);
+    return addPath(session, tlsTcpTemplSocket, error);
+}
+
+/**
+ * @brief connect a new socket as additional connection of a session. The parts of
+ *        multiblock-messages are spread over all connections of the session.
+ *
+ * @param session session, which should be extended
+ * @param socket socket of the new connection
+ *
+ * @return true, if connection was successfully created and added, else false
+ */
+bool
+SessionController::addPath(Session* session,
+                           AbstractSocket* socket,
+                           ErrorContainer &error)
+{
+    if(session == nullptr
+            || session->m_parentSession != nullptr
+            || session->m_attachToken == 0
+            || session->hasCapability(Session::MULTIPATH) == false)
+    {
+        error.addMeesage("session doesn't support additional connections");
+        delete socket;
+        return false;
+    }
+
+    Session* newPath = startSession(socket, session->m_sessionIdentifier, error, session);
+    if(newPath == nullptr) {
+        return false;
+    }
+
+    // check if the other side had accepted the new connection as additional connection
+    if(newPath->hasCapability(Session::MULTIPATH) == false)
+    {
+        error.addMeesage("other side doesn't accept the additional connection");
+        newPath->closeSession(error);
+        sleep(1);
+        delete newPath;
+        return false;
+    }
+
+    session->addPath(newPath);
+
+    return true;
+}
+
 /**
  * @brief start a new session
  *
  * @param socket socket of the new session
  * @param sessionIdentifier additional identifier as help for an upper processing-layer
+ * @param parentSession session, which should be extended by the new session as additional
+ *                      connection, or nullptr for a normal session
  *
  * @return true, if session was successfully created and connected, else false
  */
 Session*
 SessionController::startSession(AbstractSocket* socket,
                                 const std::string &sessionIdentifier,
-                                ErrorContainer &error)
+                                ErrorContainer &error,
+                                Session* parentSession)
 {
     // precheck
-    if(sessionIdentifier.size() > 64000)
+    if(sessionIdentifier.size() > MAX_SESSION_IDENTIFIER_SIZE)
     {
         delete socket;
         return nullptr;
@@ -347,6 +591,7 @@ SessionController::startSession(AbstractSocket* socket,
 
     // create new session
     Session* newSession = new Session(socket);
+    newSession->m_parentSession = parentSession;
     const uint32_t newId = SessionHandler::m_sessionHandler->increaseSessionIdCounter();
     socket->setMessageCallback(newSession, &processMessage_callback);
 
@@ -354,6 +599,8 @@ SessionController::startSession(AbstractSocket* socket,
     if(newSession->connectiSession(newId, error))
     {
         SessionHandler::m_sessionHandler->addSession(newId, newSession);
+        // keep identifier for the case, that the init has to be repeated with the legacy-message
+        newSession->m_sessionIdentifier = sessionIdentifier;
         send_Session_Init_Start(newSession, sessionIdentifier, error);
 
         while(newSession->m_initState == 0) {
@@ -23,6 +23,8 @@ INCLUDEPATH += $$PWD \
 HEADERS += \
     ../include/libKitsunemimiSakuraNetwork/session.h \
     ../include/libKitsunemimiSakuraNetwork/session_controller.h \
+    ../include/libKitsunemimiSakuraNetwork/buffer_allocator.h \
+    ../include/libKitsunemimiSakuraNetwork/session_awaitable.h \
     callbacks.h \
     message_definitions.h \
     messages_processing/session_processing.h \
@@ -32,16 +34,38 @@ HEADERS += \
     handler/session_handler.h \
     messages_processing/multiblock_data_processing.h \
     multiblock_io.h \
+    multiblock_table.h \
+    path_sender.h \
     handler/reply_handler.h \
     handler/message_blocker_handler.h \
+    handler/flush_handler.h \
+    handler/reaper_handler.h \
+    handler/timer_handler.h \
+    handler/timeout_handler.h \
+    handler/send_handler.h \
+    handler/send_queue.h \
     messages_processing/stream_data_processing.h \
-    messages_processing/singleblock_data_processing.h
+    messages_processing/singleblock_data_processing.h \
+    buffer_pool.h \
+    send_scheduler.h \
+    timer_wheel.h
 
 SOURCES += \
     handler/reply_handler.cpp \
     session.cpp \
     handler/session_handler.cpp \
     multiblock_io.cpp \
+    multiblock_table.cpp \
+    path_sender.cpp \
     handler/message_blocker_handler.cpp \
-    session_controller.cpp
+    handler/flush_handler.cpp \
+    handler/reaper_handler.cpp \
+    handler/timer_handler.cpp \
+    handler/timeout_handler.cpp \
+    handler/send_handler.cpp \
+    handler/send_queue.cpp \
+    session_controller.cpp \
+    buffer_pool.cpp \
+    send_scheduler.cpp \
+    timer_wheel.cpp
 
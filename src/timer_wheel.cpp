@@ -0,0 +1,278 @@
+/**
+ * @file       timer_wheel.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "timer_wheel.h"
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief constructor
+ */
+TimerWheel::TimerWheel()
+{
+    for(uint32_t i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; i++) {
+        m_slots[i] = TIMER_WHEEL_NO_ENTRY;
+    }
+}
+
+/**
+ * @brief destructor
+ */
+TimerWheel::~TimerWheel() {}
+
+/**
+ * @brief add a new timer
+ *
+ * @param timeout number of ticks until the timer expires
+ * @param target pointer, which is given to the callback
+ * @param processTimeout callback, which has to be called, when the timer expires
+ * @param id id, which is given to the callback
+ *
+ * @return handle of the timer to cancel it
+ */
+uint64_t
+TimerWheel::add(const uint64_t timeout,
+                void* target,
+                void (*processTimeout)(void*, const uint64_t),
+                const uint64_t id)
+{
+    // get unused entry or create a new one
+    uint32_t index = m_freeEntries;
+    if(index != TIMER_WHEEL_NO_ENTRY)
+    {
+        m_freeEntries = m_entries[index].next;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_entries.size());
+        m_entries.push_back(TimerEntry());
+    }
+
+    TimerEntry* entry = &m_entries[index];
+    entry->generation++;
+    entry->deadline = m_currentTick + (timeout == 0 ? 1 : timeout);
+    entry->timer.target = target;
+    entry->timer.processTimeout = processTimeout;
+    entry->timer.id = id;
+
+    insertEntry(index);
+    m_numberOfTimers++;
+
+    return (static_cast<uint64_t>(entry->generation) << 32) + index;
+}
+
+/**
+ * @brief remove a timer, which has not expired yet
+ *
+ * @param handle handle of the timer, which was returned by the add-method
+ *
+ * @return false, if the timer has already expired or was already canceled, else true
+ */
+bool
+TimerWheel::cancel(const uint64_t handle)
+{
+    const uint32_t index = static_cast<uint32_t>(handle & 0xFFFFFFFF);
+    const uint32_t generation = static_cast<uint32_t>(handle >> 32);
+
+    if(index >= m_entries.size()
+            || m_entries[index].generation != generation
+            || m_entries[index].slot == TIMER_WHEEL_NO_ENTRY)
+    {
+        return false;
+    }
+
+    unlinkEntry(index);
+    freeEntry(index);
+    m_numberOfTimers--;
+
+    return true;
+}
+
+/**
+ * @brief move the wheel forward and collect all timers, which expire within this time
+ *
+ * @param ticks number of ticks to move forward
+ * @param expiredTimers reference for the callbacks of the expired timers, which have to be
+ *                      called by the caller
+ */
+void
+TimerWheel::advance(const uint64_t ticks,
+                    std::vector<ExpiredTimer> &expiredTimers)
+{
+    for(uint64_t i = 0; i < ticks; i++)
+    {
+        // an empty wheel can jump directly to the new position
+        if(m_numberOfTimers == 0)
+        {
+            m_currentTick += ticks - i;
+            return;
+        }
+
+        m_currentTick++;
+
+        // move the entries of the higher levels down, when the lower levels had a full round
+        for(uint32_t level = TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+        {
+            const uint64_t mask = (1ull << (level * TIMER_WHEEL_SLOT_BITS)) - 1;
+            if((m_currentTick & mask) == 0) {
+                cascade(level);
+            }
+        }
+
+        // expire all entries of the current slot of the lowest level
+        const uint32_t slot = static_cast<uint32_t>(m_currentTick & (TIMER_WHEEL_SLOTS - 1));
+        uint32_t index = m_slots[slot];
+        m_slots[slot] = TIMER_WHEEL_NO_ENTRY;
+
+        while(index != TIMER_WHEEL_NO_ENTRY)
+        {
+            const uint32_t next = m_entries[index].next;
+            expiredTimers.push_back(m_entries[index].timer);
+            freeEntry(index);
+            m_numberOfTimers--;
+            index = next;
+        }
+    }
+}
+
+/**
+ * @brief get number of timers, which are not expired yet
+ */
+uint64_t
+TimerWheel::getNumberOfTimers() const
+{
+    return m_numberOfTimers;
+}
+
+/**
+ * @brief add an entry to the slot of its deadline. The level is the lowest one, which can cover
+ *        the distance to the deadline, so each entry is moved down at most once per level.
+ *
+ * @param index index of the entry
+ */
+void
+TimerWheel::insertEntry(const uint32_t index)
+{
+    TimerEntry* entry = &m_entries[index];
+    uint64_t deadline = entry->deadline;
+    if(deadline < m_currentTick) {
+        deadline = m_currentTick;
+    }
+
+    // deadlines, which are too far in the future, are stored at the end of the highest level
+    // and moved again, when this slot is reached
+    const uint64_t maxDistance = (1ull << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1;
+    if(deadline - m_currentTick > maxDistance) {
+        deadline = m_currentTick + maxDistance;
+    }
+
+    const uint64_t distance = deadline - m_currentTick;
+    uint32_t level = 0;
+    while(level < TIMER_WHEEL_LEVELS - 1
+          && distance >= (1ull << ((level + 1) * TIMER_WHEEL_SLOT_BITS)))
+    {
+        level++;
+    }
+
+    const uint32_t slotPos = static_cast<uint32_t>((deadline >> (level * TIMER_WHEEL_SLOT_BITS))
+                                                   & (TIMER_WHEEL_SLOTS - 1));
+    const uint32_t slot = level * TIMER_WHEEL_SLOTS + slotPos;
+
+    // add at the beginning of the list of the slot
+    entry->slot = slot;
+    entry->prev = TIMER_WHEEL_NO_ENTRY;
+    entry->next = m_slots[slot];
+    if(entry->next != TIMER_WHEEL_NO_ENTRY) {
+        m_entries[entry->next].prev = index;
+    }
+    m_slots[slot] = index;
+}
+
+/**
+ * @brief remove an entry from the list of its slot
+ *
+ * @param index index of the entry
+ */
+void
+TimerWheel::unlinkEntry(const uint32_t index)
+{
+    TimerEntry* entry = &m_entries[index];
+
+    if(entry->prev != TIMER_WHEEL_NO_ENTRY) {
+        m_entries[entry->prev].next = entry->next;
+    } else {
+        m_slots[entry->slot] = entry->next;
+    }
+
+    if(entry->next != TIMER_WHEEL_NO_ENTRY) {
+        m_entries[entry->next].prev = entry->prev;
+    }
+
+    entry->slot = TIMER_WHEEL_NO_ENTRY;
+    entry->prev = TIMER_WHEEL_NO_ENTRY;
+    entry->next = TIMER_WHEEL_NO_ENTRY;
+}
+
+/**
+ * @brief give an entry, which is not linked anymore, back to the list of unused entries
+ *
+ * @param index index of the entry
+ */
+void
+TimerWheel::freeEntry(const uint32_t index)
+{
+    TimerEntry* entry = &m_entries[index];
+    entry->slot = TIMER_WHEEL_NO_ENTRY;
+    entry->prev = TIMER_WHEEL_NO_ENTRY;
+    entry->timer = ExpiredTimer();
+    entry->next = m_freeEntries;
+    m_freeEntries = index;
+}
+
+/**
+ * @brief move all entries of the current slot of a level to the lower levels
+ *
+ * @param level level, which slot has to be moved
+ */
+void
+TimerWheel::cascade(const uint32_t level)
+{
+    const uint32_t slotPos = static_cast<uint32_t>((m_currentTick >> (level * TIMER_WHEEL_SLOT_BITS))
+                                                   & (TIMER_WHEEL_SLOTS - 1));
+    const uint32_t slot = level * TIMER_WHEEL_SLOTS + slotPos;
+
+    uint32_t index = m_slots[slot];
+    m_slots[slot] = TIMER_WHEEL_NO_ENTRY;
+
+    while(index != TIMER_WHEEL_NO_ENTRY)
+    {
+        const uint32_t next = m_entries[index].next;
+        insertEntry(index);
+        index = next;
+    }
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,96 @@
+/**
+ * @file       timer_wheel.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_SAKURA_NETWORK_TIMER_WHEEL_H
+#define KITSUNEMIMI_SAKURA_NETWORK_TIMER_WHEEL_H
+
+#include <iostream>
+#include <vector>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+// number of levels and slots per level of the timer-wheel. One tick of the lowest level is one
+// millisecond, so deadlines up to 2^32 ms (~49 days) in the future can be stored.
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOT_BITS 8
+#define TIMER_WHEEL_SLOTS (1u << TIMER_WHEEL_SLOT_BITS)
+
+// index, which marks the end of a list of entries
+#define TIMER_WHEEL_NO_ENTRY 0xFFFFFFFF
+
+class TimerWheel
+{
+public:
+    // callback of an expired timer, which gets the target and the id of the timer
+    struct ExpiredTimer
+    {
+        void* target = nullptr;
+        void (*processTimeout)(void*, const uint64_t) = nullptr;
+        uint64_t id = 0;
+    };
+
+    TimerWheel();
+    ~TimerWheel();
+
+    uint64_t add(const uint64_t timeout,
+                 void* target,
+                 void (*processTimeout)(void*, const uint64_t),
+                 const uint64_t id);
+    bool cancel(const uint64_t handle);
+    void advance(const uint64_t ticks,
+                 std::vector<ExpiredTimer> &expiredTimers);
+
+    uint64_t getNumberOfTimers() const;
+
+private:
+    struct TimerEntry
+    {
+        uint64_t deadline = 0;
+        uint32_t generation = 0;
+        uint32_t slot = TIMER_WHEEL_NO_ENTRY;
+        uint32_t prev = TIMER_WHEEL_NO_ENTRY;
+        uint32_t next = TIMER_WHEEL_NO_ENTRY;
+        ExpiredTimer timer;
+    };
+
+    // all entries are stored in one vector and linked by their index, so the handle of a timer
+    // is the index of its entry together with a generation-counter against reused entries
+    std::vector<TimerEntry> m_entries;
+    uint32_t m_freeEntries = TIMER_WHEEL_NO_ENTRY;
+    uint32_t m_slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+
+    uint64_t m_currentTick = 0;
+    uint64_t m_numberOfTimers = 0;
+
+    void insertEntry(const uint32_t index);
+    void unlinkEntry(const uint32_t index);
+    void freeEntry(const uint32_t index);
+    void cascade(const uint32_t level);
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_SAKURA_NETWORK_TIMER_WHEEL_H
@@ -0,0 +1,35 @@
+include(../../defaults.pri)
+
+QT -= qt core gui
+
+CONFIG   -= app_bundle
+CONFIG += c++17 console
+
+LIBS += -L../../src -lKitsunemimiSakuraNetwork
+INCLUDEPATH += $$PWD \
+               ../../src
+
+LIBS += -L../../../libKitsunemimiCommon/src -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/debug -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/release -lKitsunemimiCommon
+INCLUDEPATH += ../../../libKitsunemimiCommon/include
+
+LIBS += -L../../../libKitsunemimiNetwork/src -lKitsunemimiNetwork
+LIBS += -L../../../libKitsunemimiNetwork/src/debug -lKitsunemimiNetwork
+LIBS += -L../../../libKitsunemimiNetwork/src/release -lKitsunemimiNetwork
+INCLUDEPATH += ../../../libKitsunemimiNetwork/include
+
+LIBS +=  -lssl -lcrypt
+
+SOURCES += \
+    main.cpp \
+    handshake_benchmark.cpp \
+    frame_size_benchmark.cpp \
+    multiblock_table_benchmark.cpp \
+    timer_wheel_benchmark.cpp
+
+HEADERS += \
+    handshake_benchmark.h \
+    frame_size_benchmark.h \
+    multiblock_table_benchmark.h \
+    timer_wheel_benchmark.h
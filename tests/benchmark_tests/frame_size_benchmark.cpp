@@ -0,0 +1,180 @@
+/**
+ * @file       frame_size_benchmark.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "frame_size_benchmark.h"
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+FrameSize_Benchmark* FrameSize_Benchmark::m_instance = nullptr;
+
+/**
+ * @brief count incoming messages
+ */
+void frameSizeRequestCallback(void*,
+                              Session*,
+                              const uint64_t,
+                              DataBuffer* data)
+{
+    delete data;
+    FrameSize_Benchmark::m_instance->m_receivedMessages++;
+}
+
+/**
+ * @brief sessionCreateCallback
+ */
+void frameSizeCreateCallback(Kitsunemimi::Sakura::Session* session,
+                             const std::string)
+{
+    session->setRequestCallback(nullptr, &frameSizeRequestCallback);
+}
+
+/**
+ * @brief sessionCloseCallback
+ */
+void frameSizeCloseCallback(Kitsunemimi::Sakura::Session*,
+                            const std::string)
+{
+}
+
+/**
+ * @brief errorCallback
+ */
+void frameSizeErrorCallback(Kitsunemimi::Sakura::Session*,
+                            const uint8_t,
+                            const std::string message)
+{
+    std::cout<<"ERROR: "<<message<<std::endl;
+}
+
+/**
+ * @brief constructor
+ *
+ * @param messageSize size of a single message, which is splitted into frames
+ * @param numberOfMessages number of messages to send for each frame-size
+ */
+FrameSize_Benchmark::FrameSize_Benchmark(const uint64_t messageSize,
+                                         const uint32_t numberOfMessages)
+{
+    m_instance = this;
+    m_messageSize = messageSize;
+    m_numberOfMessages = numberOfMessages;
+
+    std::cout<<"=================================================="<<std::endl;
+    std::cout<<"frame-size-benchmark"<<std::endl;
+    std::cout<<"=================================================="<<std::endl;
+
+    ErrorContainer error;
+    SessionController* controller = new SessionController(&frameSizeCreateCallback,
+                                                          &frameSizeCloseCallback,
+                                                          &frameSizeErrorCallback);
+    const uint32_t serverId = controller->addUnixDomainServer("/tmp/sock_benchmark.uds", error);
+    if(serverId == 0)
+    {
+        std::cout<<"failed to create server for frame-size-benchmark"<<std::endl;
+        delete controller;
+        return;
+    }
+
+    const std::vector<uint32_t> frameSizes = {16*1024,
+                                              64*1024,
+                                              128*1024,
+                                              256*1024,
+                                              512*1024,
+                                              1024*1024,
+                                              2*1024*1024,
+                                              4*1024*1024};
+    for(const uint32_t frameSize : frameSizes) {
+        runFrameSize(controller, frameSize);
+    }
+
+    controller->closeServer(serverId);
+    delete controller;
+}
+
+/**
+ * @brief send messages with a specific frame-size and print the throughput
+ *
+ * @param controller pointer to the session-controller
+ * @param frameSize maximum single-message-size for the new session
+ */
+void
+FrameSize_Benchmark::runFrameSize(SessionController* controller,
+                                  const uint32_t frameSize)
+{
+    ErrorContainer error;
+    if(controller->setMaximumSingleSize(frameSize) == false)
+    {
+        std::cout<<"frame-size "<<frameSize<<" is not supported"<<std::endl;
+        return;
+    }
+
+    Session* session = controller->startUnixDomainSession("/tmp/sock_benchmark.uds",
+                                                          "benchmark",
+                                                          "benchmark",
+                                                          error);
+    if(session == nullptr) {
+        return;
+    }
+
+    uint8_t* data = new uint8_t[m_messageSize];
+    memset(data, 1, m_messageSize);
+    m_receivedMessages = 0;
+
+    const std::chrono::high_resolution_clock::time_point start =
+            std::chrono::high_resolution_clock::now();
+
+    for(uint32_t i = 0; i < m_numberOfMessages; i++) {
+        session->sendNormalMessage(data, m_messageSize, error);
+    }
+
+    // wait until the other side has received all messages
+    uint32_t waitCounter = 0;
+    while(m_receivedMessages < m_numberOfMessages
+          && waitCounter < 600000)
+    {
+        usleep(100);
+        waitCounter++;
+    }
+
+    const std::chrono::high_resolution_clock::time_point end =
+            std::chrono::high_resolution_clock::now();
+    const double duration = std::chrono::duration<double>(end - start).count();
+    const double totalMiB = static_cast<double>(m_messageSize * m_numberOfMessages)
+                            / (1024.0 * 1024.0);
+
+    std::cout<<"frame-size: "<<(session->getMaximumSingleSize() / 1024)<<" KiB"<<std::endl;
+    if(m_receivedMessages < m_numberOfMessages) {
+        std::cout<<"    timeout: not all messages were received"<<std::endl;
+    } else {
+        std::cout<<"    throughput: "<<(totalMiB / duration)<<" MiB/s"<<std::endl;
+    }
+
+    delete[] data;
+    session->closeSession(error);
+    delete session;
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
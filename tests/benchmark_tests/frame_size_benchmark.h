@@ -0,0 +1,59 @@
+/**
+ * @file       frame_size_benchmark.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef FRAME_SIZE_BENCHMARK_H
+#define FRAME_SIZE_BENCHMARK_H
+
+#include <iostream>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiSakuraNetwork/session_controller.h>
+#include <libKitsunemimiSakuraNetwork/session.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class FrameSize_Benchmark
+{
+public:
+    FrameSize_Benchmark(const uint64_t messageSize = 64*1024*1024,
+                        const uint32_t numberOfMessages = 8);
+
+    static FrameSize_Benchmark* m_instance;
+    std::atomic<uint64_t> m_receivedMessages;
+
+private:
+    uint64_t m_messageSize = 0;
+    uint32_t m_numberOfMessages = 0;
+
+    void runFrameSize(SessionController* controller,
+                      const uint32_t frameSize);
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // FRAME_SIZE_BENCHMARK_H
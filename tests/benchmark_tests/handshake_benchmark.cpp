@@ -0,0 +1,149 @@
+/**
+ * @file       handshake_benchmark.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "handshake_benchmark.h"
+
+#include <message_definitions.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief sessionCreateCallback
+ */
+void handshakeCreateCallback(Kitsunemimi::Sakura::Session*,
+                             const std::string)
+{
+}
+
+/**
+ * @brief sessionCloseCallback
+ */
+void handshakeCloseCallback(Kitsunemimi::Sakura::Session*,
+                            const std::string)
+{
+}
+
+/**
+ * @brief errorCallback
+ */
+void handshakeErrorCallback(Kitsunemimi::Sakura::Session*,
+                            const uint8_t,
+                            const std::string message)
+{
+    std::cout<<"ERROR: "<<message<<std::endl;
+}
+
+/**
+ * @brief constructor
+ *
+ * @param numberOfSessions number of sessions, which should be created for the time-measurement
+ */
+Handshake_Benchmark::Handshake_Benchmark(const uint32_t numberOfSessions)
+{
+    m_numberOfSessions = numberOfSessions;
+
+    std::cout<<"=================================================="<<std::endl;
+    std::cout<<"handshake-benchmark"<<std::endl;
+    std::cout<<"=================================================="<<std::endl;
+
+    printMessageSizes("test");
+    printMessageSizes(std::string(1000, 'x'));
+    runSessionBenchmark("test");
+}
+
+/**
+ * @brief print the number of bytes, which are sent over the socket for one session-handshake
+ *
+ * @param sessionIdentifier identifier, which is used for the handshake
+ */
+void
+Handshake_Benchmark::printMessageSizes(const std::string &sessionIdentifier)
+{
+    const uint64_t legacySize = sizeof(Session_Init_Start_Message)
+                                + sizeof(Session_Init_Reply_Message);
+    const uint64_t compactSize = calcMessageSize(sizeof(Session_Init_Compact_Start_Header),
+                                                 sessionIdentifier.size())
+                                 + calcMessageSize(sizeof(Session_Init_Compact_Reply_Header),
+                                                   sessionIdentifier.size());
+
+    std::cout<<"identifier-size: "<<sessionIdentifier.size()<<" Byte"<<std::endl;
+    std::cout<<"    legacy handshake:  "<<legacySize<<" Byte per session"<<std::endl;
+    std::cout<<"    compact handshake: "<<compactSize<<" Byte per session"<<std::endl;
+}
+
+/**
+ * @brief create and close sessions over a unix-domain-socket and measure the time per session
+ *
+ * @param sessionIdentifier identifier, which is used for the handshake
+ */
+void
+Handshake_Benchmark::runSessionBenchmark(const std::string &sessionIdentifier)
+{
+    ErrorContainer error;
+    SessionController* controller = new SessionController(&handshakeCreateCallback,
+                                                          &handshakeCloseCallback,
+                                                          &handshakeErrorCallback);
+    const uint32_t serverId = controller->addUnixDomainServer("/tmp/sock_benchmark.uds", error);
+    if(serverId == 0)
+    {
+        std::cout<<"failed to create server for handshake-benchmark"<<std::endl;
+        delete controller;
+        return;
+    }
+
+    uint32_t successful = 0;
+    const std::chrono::high_resolution_clock::time_point start =
+            std::chrono::high_resolution_clock::now();
+
+    for(uint32_t i = 0; i < m_numberOfSessions; i++)
+    {
+        Session* session = controller->startUnixDomainSession("/tmp/sock_benchmark.uds",
+                                                              sessionIdentifier,
+                                                              "benchmark",
+                                                              error);
+        if(session == nullptr) {
+            continue;
+        }
+
+        successful++;
+        session->closeSession(error);
+        delete session;
+    }
+
+    const std::chrono::high_resolution_clock::time_point end =
+            std::chrono::high_resolution_clock::now();
+    const double duration = std::chrono::duration<double, std::micro>(end - start).count();
+
+    std::cout<<"sessions created: "<<successful<<" of "<<m_numberOfSessions<<std::endl;
+    if(successful > 0) {
+        std::cout<<"    time per session: "<<(duration / successful)<<" us"<<std::endl;
+    }
+
+    controller->closeServer(serverId);
+    delete controller;
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,52 @@
+/**
+ * @file       handshake_benchmark.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef HANDSHAKE_BENCHMARK_H
+#define HANDSHAKE_BENCHMARK_H
+
+#include <iostream>
+#include <chrono>
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiSakuraNetwork/session_controller.h>
+#include <libKitsunemimiSakuraNetwork/session.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class Handshake_Benchmark
+{
+public:
+    Handshake_Benchmark(const uint32_t numberOfSessions = 1000);
+
+private:
+    uint32_t m_numberOfSessions = 0;
+
+    void printMessageSizes(const std::string &sessionIdentifier);
+    void runSessionBenchmark(const std::string &sessionIdentifier);
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // HANDSHAKE_BENCHMARK_H
@@ -0,0 +1,36 @@
+/**
+ * @file    main.cpp
+ *
+ * @author  Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiCommon/logger.h>
+
+#include <handshake_benchmark.h>
+#include <frame_size_benchmark.h>
+#include <multiblock_table_benchmark.h>
+#include <timer_wheel_benchmark.h>
+
+int main()
+{
+    Kitsunemimi::Sakura::Handshake_Benchmark();
+    Kitsunemimi::Sakura::FrameSize_Benchmark();
+    Kitsunemimi::Sakura::MultiblockTable_Benchmark();
+    Kitsunemimi::Sakura::TimerWheel_Benchmark();
+}
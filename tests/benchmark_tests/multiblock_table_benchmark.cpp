@@ -0,0 +1,272 @@
+/**
+ * @file       multiblock_table_benchmark.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "multiblock_table_benchmark.h"
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <cstring>
+
+#include <multiblock_table.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+// entry for the comparison with the previous map, which was protected by a single mutex
+struct MapEntry
+{
+    uint32_t receivedParts = 0;
+    std::vector<uint64_t> receivedBitmap;
+    uint8_t* data = nullptr;
+};
+
+/**
+ * @brief get the id of a message within the benchmark, which doesn't collide with the reserved
+ *        keys of the table
+ */
+inline uint64_t
+getBenchmarkId(const uint32_t messageNumber)
+{
+    return 1000 + static_cast<uint64_t>(messageNumber) * 7919;
+}
+
+/**
+ * @brief constructor
+ *
+ * @param numberOfMessages number of multiblock-messages, which are received at the same time
+ * @param numberOfParts number of parts of each message
+ * @param partSize size of each part in bytes
+ */
+MultiblockTable_Benchmark::MultiblockTable_Benchmark(const uint32_t numberOfMessages,
+                                                     const uint32_t numberOfParts,
+                                                     const uint32_t partSize)
+{
+    m_numberOfMessages = numberOfMessages;
+    m_numberOfParts = numberOfParts;
+    m_partSize = partSize;
+
+    std::cout<<"=================================================="<<std::endl;
+    std::cout<<"multiblock-table-benchmark"<<std::endl;
+    std::cout<<"=================================================="<<std::endl;
+
+    const std::vector<uint32_t> threadNumbers = {1, 2, 4, 8};
+    for(const uint32_t numberOfThreads : threadNumbers)
+    {
+        const double mapRate = runMapIngestion(numberOfThreads);
+        const double tableRate = runTableIngestion(numberOfThreads);
+
+        std::cout<<"threads: "<<numberOfThreads<<std::endl;
+        std::cout<<"    map with mutex: "<<(mapRate / 1000000.0)<<" M parts/s"<<std::endl;
+        std::cout<<"    table:          "<<(tableRate / 1000000.0)<<" M parts/s"<<std::endl;
+    }
+}
+
+/**
+ * @brief write all parts into a std::map, which is protected by a mutex, like the incoming
+ *        multiblock-messages were handled before the table
+ *
+ * @param numberOfThreads number of threads, which write parts at the same time, like the
+ *                        connections of a multipath-session
+ *
+ * @return number of ingested parts per second
+ */
+double
+MultiblockTable_Benchmark::runMapIngestion(const uint32_t numberOfThreads)
+{
+    std::mutex lock;
+    std::map<uint64_t, MapEntry> messages;
+    for(uint32_t i = 0; i < m_numberOfMessages; i++)
+    {
+        MapEntry entry;
+        entry.receivedBitmap.resize((m_numberOfParts + 63) / 64, 0);
+        entry.data = new uint8_t[static_cast<uint64_t>(m_numberOfParts) * m_partSize];
+        messages.insert(std::make_pair(getBenchmarkId(i), entry));
+    }
+
+    std::vector<uint8_t> part(m_partSize, 1);
+    std::atomic<uint64_t> completeMessages{0};
+
+    // each thread writes every n-th part of all messages
+    auto worker = [&](const uint32_t threadId)
+    {
+        for(uint32_t partId = threadId; partId < m_numberOfParts; partId += numberOfThreads)
+        {
+            for(uint32_t i = 0; i < m_numberOfMessages; i++)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                std::map<uint64_t, MapEntry>::iterator it;
+                it = messages.find(getBenchmarkId(i));
+                if(it == messages.end()) {
+                    continue;
+                }
+
+                uint64_t* bitmapBlock = &it->second.receivedBitmap[partId / 64];
+                const uint64_t partBit = 1ul << (partId % 64);
+                if((*bitmapBlock & partBit) == 0)
+                {
+                    const uint64_t offset = static_cast<uint64_t>(partId) * m_partSize;
+                    memcpy(it->second.data + offset, &part[0], m_partSize);
+                    *bitmapBlock |= partBit;
+                    it->second.receivedParts++;
+                    if(it->second.receivedParts == m_numberOfParts) {
+                        completeMessages++;
+                    }
+                }
+            }
+        }
+    };
+
+    const std::chrono::high_resolution_clock::time_point start =
+            std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    for(uint32_t i = 0; i < numberOfThreads; i++) {
+        threads.push_back(std::thread(worker, i));
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+
+    const std::chrono::high_resolution_clock::time_point end =
+            std::chrono::high_resolution_clock::now();
+    const double duration = std::chrono::duration<double>(end - start).count();
+
+    if(completeMessages != m_numberOfMessages) {
+        std::cout<<"ERROR: not all messages were completed by the map"<<std::endl;
+    }
+
+    std::map<uint64_t, MapEntry>::iterator it;
+    for(it = messages.begin(); it != messages.end(); it++) {
+        delete[] it->second.data;
+    }
+
+    return static_cast<double>(m_numberOfMessages) * m_numberOfParts / duration;
+}
+
+/**
+ * @brief write all parts into the multiblock-table in the same way as the incoming parts of a
+ *        session are written
+ *
+ * @param numberOfThreads number of threads, which write parts at the same time, like the
+ *                        connections of a multipath-session
+ *
+ * @return number of ingested parts per second
+ */
+double
+MultiblockTable_Benchmark::runTableIngestion(const uint32_t numberOfThreads)
+{
+    MultiblockTable table(MULTIBLOCK_TABLE_SIZE);
+    for(uint32_t i = 0; i < m_numberOfMessages; i++)
+    {
+        const uint64_t messageSize = static_cast<uint64_t>(m_numberOfParts) * m_partSize;
+
+        MultiblockIO::MultiblockBuffer buffer;
+        buffer.multiblockId = getBenchmarkId(i);
+        buffer.messageSize = messageSize;
+        buffer.numberOfPackages = m_numberOfParts;
+        buffer.partSize = m_partSize;
+        buffer.receivedBitmap.resize((m_numberOfParts + 63) / 64, 0);
+        buffer.incomingData = new DataBuffer(calcBytesToBlocks(messageSize));
+
+        MultiblockSlot* slot = table.insert(buffer);
+        if(slot == nullptr)
+        {
+            std::cout<<"ERROR: failed to insert message into the table"<<std::endl;
+            return 0.0;
+        }
+        table.release(slot);
+    }
+
+    std::vector<uint8_t> part(m_partSize, 1);
+    std::atomic<uint64_t> completeMessages{0};
+
+    // each thread writes every n-th part of all messages
+    auto worker = [&](const uint32_t threadId)
+    {
+        for(uint32_t partId = threadId; partId < m_numberOfParts; partId += numberOfThreads)
+        {
+            for(uint32_t i = 0; i < m_numberOfMessages; i++)
+            {
+                MultiblockSlot* slot = table.acquire(getBenchmarkId(i));
+                if(slot == nullptr) {
+                    continue;
+                }
+
+                const uint64_t partBit = 1ul << (partId % 64);
+                const uint64_t oldBlock = slot->receivedBitmap[partId / 64].fetch_or(partBit);
+                if((oldBlock & partBit) == 0)
+                {
+                    const uint64_t offset = static_cast<uint64_t>(partId) * m_partSize;
+                    uint8_t* data = static_cast<uint8_t*>(slot->buffer.incomingData->data);
+                    memcpy(data + offset, &part[0], m_partSize);
+                    if(slot->receivedParts.fetch_add(1) + 1 == m_numberOfParts) {
+                        completeMessages++;
+                    }
+                }
+
+                table.release(slot);
+            }
+        }
+    };
+
+    const std::chrono::high_resolution_clock::time_point start =
+            std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    for(uint32_t i = 0; i < numberOfThreads; i++) {
+        threads.push_back(std::thread(worker, i));
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+
+    const std::chrono::high_resolution_clock::time_point end =
+            std::chrono::high_resolution_clock::now();
+    const double duration = std::chrono::duration<double>(end - start).count();
+
+    if(completeMessages != m_numberOfMessages) {
+        std::cout<<"ERROR: not all messages were completed by the table"<<std::endl;
+    }
+
+    // remove all messages again
+    for(uint32_t i = 0; i < m_numberOfMessages; i++)
+    {
+        MultiblockSlot* slot = table.acquire(getBenchmarkId(i));
+        if(slot == nullptr) {
+            continue;
+        }
+
+        MultiblockIO::MultiblockBuffer removedBuffer;
+        table.remove(slot, getBenchmarkId(i), true, removedBuffer);
+        table.release(slot);
+        delete removedBuffer.incomingData;
+    }
+
+    return static_cast<double>(m_numberOfMessages) * m_numberOfParts / duration;
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
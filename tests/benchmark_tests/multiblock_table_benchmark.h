@@ -0,0 +1,56 @@
+/**
+ * @file       multiblock_table_benchmark.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MULTIBLOCK_TABLE_BENCHMARK_H
+#define MULTIBLOCK_TABLE_BENCHMARK_H
+
+#include <iostream>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class MultiblockTable_Benchmark
+{
+public:
+    MultiblockTable_Benchmark(const uint32_t numberOfMessages = 64,
+                              const uint32_t numberOfParts = 4096,
+                              const uint32_t partSize = 1024);
+
+private:
+    uint32_t m_numberOfMessages = 0;
+    uint32_t m_numberOfParts = 0;
+    uint32_t m_partSize = 0;
+
+    double runMapIngestion(const uint32_t numberOfThreads);
+    double runTableIngestion(const uint32_t numberOfThreads);
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // MULTIBLOCK_TABLE_BENCHMARK_H
@@ -0,0 +1,194 @@
+/**
+ * @file       timer_wheel_benchmark.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "timer_wheel_benchmark.h"
+
+#include <timer_wheel.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+// entry for the comparison with the previous list, where each tick decrements all timers
+struct ListEntry
+{
+    uint64_t id = 0;
+    uint64_t timer = 0;
+};
+
+/**
+ * @brief callback for expired timers of the benchmark, which only counts them
+ */
+void
+countTimeout(void* target, const uint64_t)
+{
+    uint64_t* counter = static_cast<uint64_t*>(target);
+    *counter += 1;
+}
+
+/**
+ * @brief constructor
+ *
+ * @param numberOfTimers number of timers, which are active at the same time, like messages,
+ *                       which wait for their reply
+ * @param timersPerTick number of timers, which are removed and added again in each tick, like
+ *                      replies, which arrived within one millisecond
+ * @param numberOfTicks number of ticks of the benchmark
+ */
+TimerWheel_Benchmark::TimerWheel_Benchmark(const uint32_t numberOfTimers,
+                                           const uint32_t timersPerTick,
+                                           const uint32_t numberOfTicks)
+{
+    m_numberOfTimers = numberOfTimers;
+    m_timersPerTick = timersPerTick;
+    m_numberOfTicks = numberOfTicks;
+
+    std::cout<<"=================================================="<<std::endl;
+    std::cout<<"timer-wheel-benchmark"<<std::endl;
+    std::cout<<"=================================================="<<std::endl;
+
+    const double listDuration = runListTimers();
+    const double wheelDuration = runWheelTimers();
+
+    std::cout<<"active timers: "<<m_numberOfTimers<<std::endl;
+    std::cout<<"    list:  "<<(listDuration * 1000000.0 / m_numberOfTicks)<<" us/tick"<<std::endl;
+    std::cout<<"    wheel: "<<(wheelDuration * 1000000.0 / m_numberOfTicks)<<" us/tick"<<std::endl;
+}
+
+/**
+ * @brief handle the timers within a vector, which is scanned for each removed timer and for each
+ *        tick, like the timeouts were handled before the timer-wheel
+ *
+ * @return duration in seconds
+ */
+double
+TimerWheel_Benchmark::runListTimers()
+{
+    std::vector<ListEntry> timers;
+    uint64_t nextId = 0;
+    uint64_t oldestId = 0;
+    uint64_t expiredTimers = 0;
+
+    for(uint32_t i = 0; i < m_numberOfTimers; i++)
+    {
+        ListEntry entry;
+        entry.id = nextId++;
+        entry.timer = 2000;
+        timers.push_back(entry);
+    }
+
+    const std::chrono::high_resolution_clock::time_point start =
+            std::chrono::high_resolution_clock::now();
+
+    for(uint32_t tick = 0; tick < m_numberOfTicks; tick++)
+    {
+        // replies arrived for the oldest timers
+        for(uint32_t i = 0; i < m_timersPerTick; i++)
+        {
+            const uint64_t id = oldestId++;
+            for(uint64_t pos = 0; pos < timers.size(); pos++)
+            {
+                if(timers[pos].id == id)
+                {
+                    std::swap(timers[pos], timers[timers.size() - 1]);
+                    timers.pop_back();
+                    break;
+                }
+            }
+
+            ListEntry entry;
+            entry.id = nextId++;
+            entry.timer = 2000;
+            timers.push_back(entry);
+        }
+
+        // decrement all timers
+        for(uint64_t pos = 0; pos < timers.size(); pos++)
+        {
+            timers[pos].timer -= 1;
+            if(timers[pos].timer == 0) {
+                expiredTimers++;
+            }
+        }
+    }
+
+    const std::chrono::high_resolution_clock::time_point end =
+            std::chrono::high_resolution_clock::now();
+
+    if(expiredTimers != 0) {
+        std::cout<<"ERROR: timers of the list expired"<<std::endl;
+    }
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * @brief handle the timers within the timer-wheel in the same way as the timeouts of replies and
+ *        requests are handled
+ *
+ * @return duration in seconds
+ */
+double
+TimerWheel_Benchmark::runWheelTimers()
+{
+    TimerWheel timerWheel;
+    std::vector<uint64_t> handles;
+    std::vector<TimerWheel::ExpiredTimer> expired;
+    uint64_t oldestId = 0;
+    uint64_t expiredTimers = 0;
+
+    for(uint32_t i = 0; i < m_numberOfTimers; i++) {
+        handles.push_back(timerWheel.add(2000, &expiredTimers, &countTimeout, handles.size()));
+    }
+
+    const std::chrono::high_resolution_clock::time_point start =
+            std::chrono::high_resolution_clock::now();
+
+    for(uint32_t tick = 0; tick < m_numberOfTicks; tick++)
+    {
+        // replies arrived for the oldest timers
+        for(uint32_t i = 0; i < m_timersPerTick; i++)
+        {
+            timerWheel.cancel(handles[oldestId++]);
+            handles.push_back(timerWheel.add(2000, &expiredTimers, &countTimeout, handles.size()));
+        }
+
+        expired.clear();
+        timerWheel.advance(1, expired);
+        for(uint64_t j = 0; j < expired.size(); j++) {
+            expired[j].processTimeout(expired[j].target, expired[j].id);
+        }
+    }
+
+    const std::chrono::high_resolution_clock::time_point end =
+            std::chrono::high_resolution_clock::now();
+
+    if(expiredTimers != 0) {
+        std::cout<<"ERROR: timers of the wheel expired"<<std::endl;
+    }
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
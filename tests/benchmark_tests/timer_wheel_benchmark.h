@@ -0,0 +1,55 @@
+/**
+ * @file       timer_wheel_benchmark.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef TIMER_WHEEL_BENCHMARK_H
+#define TIMER_WHEEL_BENCHMARK_H
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class TimerWheel_Benchmark
+{
+public:
+    TimerWheel_Benchmark(const uint32_t numberOfTimers = 100000,
+                         const uint32_t timersPerTick = 100,
+                         const uint32_t numberOfTicks = 100);
+
+private:
+    uint32_t m_numberOfTimers = 0;
+    uint32_t m_timersPerTick = 0;
+    uint32_t m_numberOfTicks = 0;
+
+    double runListTimers();
+    double runWheelTimers();
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // TIMER_WHEEL_BENCHMARK_H
@@ -0,0 +1,251 @@
+/**
+ * @file       coroutine_echo_benchmark.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "coroutine_echo_benchmark.h"
+
+#include <thread>
+#include <vector>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief task of a coroutine, which runs until its end without handle for the caller
+ */
+struct EchoTask
+{
+    struct promise_type
+    {
+        EchoTask get_return_object() { return EchoTask(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/**
+ * @brief send requests one after another within a coroutine and wait for each echo
+ */
+EchoTask
+runEchoCoroutine(CoroutineEcho_Benchmark* benchmark,
+                 Session* session)
+{
+    for(uint32_t i = 0; i < benchmark->m_numberOfRequests; i++)
+    {
+        DataBuffer* response = co_await request(session,
+                                                benchmark->m_message.c_str(),
+                                                benchmark->m_message.size(),
+                                                10);
+        if(response == nullptr) {
+            benchmark->m_failedRequests++;
+        } else {
+            SessionController::m_sessionController->releaseBuffer(response);
+        }
+    }
+
+    benchmark->m_finishedCoroutines++;
+}
+
+/**
+ * @brief send the request back to the other side
+ */
+void echoRequestCallback(void*,
+                         Session* session,
+                         const uint64_t blockerId,
+                         DataBuffer* data)
+{
+    session->sendResponse(data->data, data->usedBufferSize, blockerId, session->sessionError);
+    SessionController::m_sessionController->releaseBuffer(data);
+}
+
+/**
+ * @brief sessionCreateCallback
+ */
+void echoCreateCallback(Kitsunemimi::Sakura::Session* session,
+                        const std::string)
+{
+    session->setRequestCallback(nullptr, &echoRequestCallback);
+}
+
+/**
+ * @brief sessionCloseCallback
+ */
+void echoCloseCallback(Kitsunemimi::Sakura::Session*,
+                       const std::string)
+{
+}
+
+/**
+ * @brief errorCallback
+ */
+void echoErrorCallback(Kitsunemimi::Sakura::Session*,
+                       const uint8_t,
+                       const std::string message)
+{
+    std::cout<<"ERROR: "<<message<<std::endl;
+}
+
+/**
+ * @brief constructor
+ *
+ * @param numberOfCoroutines number of coroutines or threads, which send requests at the same time
+ * @param numberOfRequests number of requests, which are sent one after another by each of them
+ * @param messageSize size of each request
+ */
+CoroutineEcho_Benchmark::CoroutineEcho_Benchmark(const uint32_t numberOfCoroutines,
+                                                 const uint32_t numberOfRequests,
+                                                 const uint64_t messageSize)
+{
+    m_numberOfCoroutines = numberOfCoroutines;
+    m_numberOfRequests = numberOfRequests;
+    m_message = std::string(messageSize, 'x');
+
+    std::cout<<"=================================================="<<std::endl;
+    std::cout<<"coroutine-echo-benchmark"<<std::endl;
+    std::cout<<"=================================================="<<std::endl;
+
+    ErrorContainer error;
+    SessionController* controller = new SessionController(&echoCreateCallback,
+                                                          &echoCloseCallback,
+                                                          &echoErrorCallback);
+    const uint32_t serverId = controller->addUnixDomainServer("/tmp/sock_coroutine.uds", error);
+    if(serverId == 0)
+    {
+        std::cout<<"failed to create server for coroutine-echo-benchmark"<<std::endl;
+        delete controller;
+        return;
+    }
+
+    Session* session = controller->startUnixDomainSession("/tmp/sock_coroutine.uds",
+                                                          "benchmark",
+                                                          "benchmark",
+                                                          error);
+    if(session != nullptr)
+    {
+        runCoroutines(session);
+        runThreads(session);
+
+        session->closeSession(error);
+        delete session;
+    }
+
+    controller->closeServer(serverId);
+    delete controller;
+}
+
+/**
+ * @brief send all requests by coroutines, which are all started by the calling thread and
+ *        resumed by the thread of the socket
+ *
+ * @param session pointer to the session
+ */
+void
+CoroutineEcho_Benchmark::runCoroutines(Session* session)
+{
+    m_finishedCoroutines = 0;
+    m_failedRequests = 0;
+
+    const std::chrono::high_resolution_clock::time_point start =
+            std::chrono::high_resolution_clock::now();
+
+    for(uint32_t i = 0; i < m_numberOfCoroutines; i++) {
+        runEchoCoroutine(this, session);
+    }
+
+    // wait until all coroutines have finished
+    uint32_t waitCounter = 0;
+    while(m_finishedCoroutines < m_numberOfCoroutines
+          && waitCounter < 600000)
+    {
+        usleep(100);
+        waitCounter++;
+    }
+
+    const std::chrono::high_resolution_clock::time_point end =
+            std::chrono::high_resolution_clock::now();
+    const double duration = std::chrono::duration<double>(end - start).count();
+    const double numberOfRequests = static_cast<double>(m_numberOfCoroutines)
+                                    * m_numberOfRequests;
+
+    std::cout<<"coroutines: "<<m_numberOfCoroutines<<std::endl;
+    if(m_finishedCoroutines < m_numberOfCoroutines) {
+        std::cout<<"    timeout: not all coroutines have finished"<<std::endl;
+    } else {
+        std::cout<<"    requests per second: "<<(numberOfRequests / duration)<<std::endl;
+    }
+    std::cout<<"    failed requests: "<<m_failedRequests<<std::endl;
+}
+
+/**
+ * @brief send all requests with blocking requests by the same number of threads for comparison
+ *
+ * @param session pointer to the session
+ */
+void
+CoroutineEcho_Benchmark::runThreads(Session* session)
+{
+    m_failedRequests = 0;
+
+    auto worker = [&]()
+    {
+        ErrorContainer error;
+        for(uint32_t i = 0; i < m_numberOfRequests; i++)
+        {
+            DataBuffer* response = session->sendRequest(m_message.c_str(),
+                                                        m_message.size(),
+                                                        10,
+                                                        error);
+            if(response == nullptr) {
+                m_failedRequests++;
+            } else {
+                SessionController::m_sessionController->releaseBuffer(response);
+            }
+        }
+    };
+
+    const std::chrono::high_resolution_clock::time_point start =
+            std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    for(uint32_t i = 0; i < m_numberOfCoroutines; i++) {
+        threads.push_back(std::thread(worker));
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+
+    const std::chrono::high_resolution_clock::time_point end =
+            std::chrono::high_resolution_clock::now();
+    const double duration = std::chrono::duration<double>(end - start).count();
+    const double numberOfRequests = static_cast<double>(m_numberOfCoroutines)
+                                    * m_numberOfRequests;
+
+    std::cout<<"blocking threads: "<<m_numberOfCoroutines<<std::endl;
+    std::cout<<"    requests per second: "<<(numberOfRequests / duration)<<std::endl;
+    std::cout<<"    failed requests: "<<m_failedRequests<<std::endl;
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
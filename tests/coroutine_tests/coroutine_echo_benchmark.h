@@ -0,0 +1,62 @@
+/**
+ * @file       coroutine_echo_benchmark.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef COROUTINE_ECHO_BENCHMARK_H
+#define COROUTINE_ECHO_BENCHMARK_H
+
+#include <iostream>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiSakuraNetwork/session_controller.h>
+#include <libKitsunemimiSakuraNetwork/session.h>
+#include <libKitsunemimiSakuraNetwork/session_awaitable.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+class CoroutineEcho_Benchmark
+{
+public:
+    CoroutineEcho_Benchmark(const uint32_t numberOfCoroutines = 64,
+                            const uint32_t numberOfRequests = 1000,
+                            const uint64_t messageSize = 128);
+
+    std::string m_message = "";
+    uint32_t m_numberOfRequests = 0;
+    std::atomic<uint32_t> m_finishedCoroutines;
+    std::atomic<uint64_t> m_failedRequests;
+
+private:
+    uint32_t m_numberOfCoroutines = 0;
+
+    void runCoroutines(Session* session);
+    void runThreads(Session* session);
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // COROUTINE_ECHO_BENCHMARK_H
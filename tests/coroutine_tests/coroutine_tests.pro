@@ -0,0 +1,29 @@
+include(../../defaults.pri)
+
+QT -= qt core gui
+
+CONFIG   -= app_bundle
+# the awaitables of the session are only available with C++20
+CONFIG += c++2a console
+
+LIBS += -L../../src -lKitsunemimiSakuraNetwork
+INCLUDEPATH += $$PWD
+
+LIBS += -L../../../libKitsunemimiCommon/src -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/debug -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/release -lKitsunemimiCommon
+INCLUDEPATH += ../../../libKitsunemimiCommon/include
+
+LIBS += -L../../../libKitsunemimiNetwork/src -lKitsunemimiNetwork
+LIBS += -L../../../libKitsunemimiNetwork/src/debug -lKitsunemimiNetwork
+LIBS += -L../../../libKitsunemimiNetwork/src/release -lKitsunemimiNetwork
+INCLUDEPATH += ../../../libKitsunemimiNetwork/include
+
+LIBS +=  -lssl -lcrypt
+
+SOURCES += \
+    main.cpp \
+    coroutine_echo_benchmark.cpp
+
+HEADERS += \
+    coroutine_echo_benchmark.h
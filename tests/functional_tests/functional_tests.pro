@@ -22,7 +22,9 @@ LIBS +=  -lssl -lcrypt
 
 SOURCES += \
     main.cpp \
-    session_test.cpp
+    session_test.cpp \
+    send_scheduler_test.cpp
 
 HEADERS += \
-    session_test.h
+    session_test.h \
+    send_scheduler_test.h
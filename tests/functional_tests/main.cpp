@@ -23,10 +23,12 @@
 #include <libKitsunemimiCommon/logger.h>
 
 #include <session_test.h>
+#include <send_scheduler_test.h>
 
 int main()
 {
     Kitsunemimi::initConsoleLogger(true);
 
     Kitsunemimi::Sakura::Session_Test();
+    Kitsunemimi::Sakura::SendScheduler_Test();
 }
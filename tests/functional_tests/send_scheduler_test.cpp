@@ -0,0 +1,187 @@
+/**
+ * @file       send_scheduler_test.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "send_scheduler_test.h"
+
+#include <thread>
+#include <unistd.h>
+
+#include <send_scheduler.h>
+#include <message_definitions.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+
+/**
+ * @brief SendScheduler_Test::SendScheduler_Test
+ */
+SendScheduler_Test::SendScheduler_Test()
+    : Kitsunemimi::CompareTestHelper("SendScheduler_Test")
+{
+    smallFrame_waitsForOneBulkFrame_test();
+    bulkFrames_inTurns_test();
+    bulkFrame_afterSmallFramesInRow_test();
+}
+
+/**
+ * @brief a small frame, which is waiting together with a part of a multiblock-message, is written
+ *        directly after the part, which is currently written
+ */
+void
+SendScheduler_Test::smallFrame_waitsForOneBulkFrame_test()
+{
+    SendScheduler scheduler;
+    m_order.clear();
+
+    // a part of a big transfer is currently written
+    scheduler.lockBulk();
+
+    std::thread bulkThread(&SendScheduler_Test::writeBulkFrames, this, &scheduler, "bulk", 1);
+    usleep(10000);
+    std::thread smallThread(&SendScheduler_Test::writeSmallFrame, this, &scheduler, "small");
+    usleep(10000);
+
+    scheduler.unlock();
+    bulkThread.join();
+    smallThread.join();
+
+    TEST_EQUAL(m_order.size(), 2);
+    TEST_EQUAL(m_order[0], std::string("small"));
+    TEST_EQUAL(m_order[1], std::string("bulk"));
+}
+
+/**
+ * @brief the parts of two concurrent multiblock-messages are written in turns
+ */
+void
+SendScheduler_Test::bulkFrames_inTurns_test()
+{
+    SendScheduler scheduler;
+    m_order.clear();
+
+    // block the socket until both transfers are waiting
+    scheduler.lock();
+
+    std::thread firstThread(&SendScheduler_Test::writeBulkFrames, this, &scheduler, "first", 4);
+    usleep(10000);
+    std::thread secondThread(&SendScheduler_Test::writeBulkFrames, this, &scheduler, "second", 4);
+    usleep(10000);
+
+    scheduler.unlock();
+    firstThread.join();
+    secondThread.join();
+
+    TEST_EQUAL(m_order.size(), 8);
+    for(uint32_t i = 0; i < m_order.size(); i++)
+    {
+        if(i % 2 == 0) {
+            TEST_EQUAL(m_order[i], std::string("first"));
+        } else {
+            TEST_EQUAL(m_order[i], std::string("second"));
+        }
+    }
+}
+
+/**
+ * @brief a waiting part of a multiblock-message gets its turn after the maximum number of small
+ *        frames in a row, even if there are still small frames waiting
+ */
+void
+SendScheduler_Test::bulkFrame_afterSmallFramesInRow_test()
+{
+    SendScheduler scheduler;
+    m_order.clear();
+
+    const uint32_t numberOfSmallFrames = 2 * MAX_SMALL_FRAMES_IN_ROW;
+
+    // block the socket until all frames are waiting
+    scheduler.lock();
+
+    std::thread bulkThread(&SendScheduler_Test::writeBulkFrames, this, &scheduler, "bulk", 1);
+    usleep(10000);
+    std::vector<std::thread> smallThreads;
+    for(uint32_t i = 0; i < numberOfSmallFrames; i++) {
+        smallThreads.push_back(std::thread(&SendScheduler_Test::writeSmallFrame,
+                                           this,
+                                           &scheduler,
+                                           "small"));
+    }
+    usleep(10000);
+
+    scheduler.unlock();
+    bulkThread.join();
+    for(std::thread &thread : smallThreads) {
+        thread.join();
+    }
+
+    TEST_EQUAL(m_order.size(), numberOfSmallFrames + 1);
+    uint32_t bulkPosition = 0;
+    for(uint32_t i = 0; i < m_order.size(); i++)
+    {
+        if(m_order[i] == "bulk") {
+            bulkPosition = i;
+        }
+    }
+    TEST_EQUAL(bulkPosition, MAX_SMALL_FRAMES_IN_ROW);
+}
+
+/**
+ * @brief write a small frame and remember its position
+ *
+ * @param scheduler scheduler of the socket
+ * @param name name of the frame within the order
+ */
+void
+SendScheduler_Test::writeSmallFrame(SendScheduler* scheduler,
+                                    const std::string &name)
+{
+    scheduler->lock();
+    m_order.push_back(name);
+    usleep(100);
+    scheduler->unlock();
+}
+
+/**
+ * @brief write the parts of a multiblock-message and remember their positions
+ *
+ * @param scheduler scheduler of the socket
+ * @param name name of the transfer within the order
+ * @param numberOfFrames number of parts of the transfer
+ */
+void
+SendScheduler_Test::writeBulkFrames(SendScheduler* scheduler,
+                                    const std::string &name,
+                                    const uint32_t numberOfFrames)
+{
+    for(uint32_t i = 0; i < numberOfFrames; i++)
+    {
+        scheduler->lockBulk();
+        m_order.push_back(name);
+        usleep(1000);
+        scheduler->unlock();
+    }
+}
+
+} // namespace Sakura
+} // namespace Kitsunemimi
@@ -0,0 +1,60 @@
+/**
+ * @file       send_scheduler_test.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef SEND_SCHEDULER_TEST_H
+#define SEND_SCHEDULER_TEST_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <libKitsunemimiCommon/test_helper/compare_test_helper.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura
+{
+class SendScheduler;
+
+class SendScheduler_Test
+        : public Kitsunemimi::CompareTestHelper
+{
+public:
+    SendScheduler_Test();
+
+private:
+    std::vector<std::string> m_order;
+
+    void smallFrame_waitsForOneBulkFrame_test();
+    void bulkFrames_inTurns_test();
+    void bulkFrame_afterSmallFramesInRow_test();
+
+    void writeSmallFrame(SendScheduler* scheduler, const std::string &name);
+    void writeBulkFrames(SendScheduler* scheduler,
+                         const std::string &name,
+                         const uint32_t numberOfFrames);
+};
+
+} // namespace Sakura
+} // namespace Kitsunemimi
+
+#endif // SEND_SCHEDULER_TEST_H
@@ -89,16 +89,165 @@ void standaloneDataCallback(void* target,
                           blockerId,
                           session->sessionError);
 
-    delete data;
+    SessionController::m_sessionController->releaseBuffer(data);
+}
+
+/**
+ * @brief requestViewCallback
+ */
+void requestViewCallback(void* target,
+                         Session* session,
+                         const uint64_t blockerId,
+                         const void* data,
+                         const uint64_t dataSize)
+{
+    Session_Test* instance = static_cast<Session_Test*>(target);
+    instance->m_numberOfRequestViews++;
+
+    // keep a copy of the view, which is still valid after the callback
+    if(instance->m_detachedRequest != nullptr) {
+        SessionController::m_sessionController->releaseBuffer(instance->m_detachedRequest);
+    }
+    instance->m_detachedRequest = session->detachData(data, dataSize);
+
+    const std::string receivedMessage(static_cast<const char*>(data), dataSize);
+    const std::string responseMessage = receivedMessage + "_response";
+    session->sendResponse(responseMessage.c_str(),
+                          responseMessage.size(),
+                          blockerId,
+                          session->sessionError);
+}
+
+/**
+ * @brief multiblockAllocationCallback
+ */
+DataBuffer* multiblockAllocationCallback(void* target,
+                                         Session*,
+                                         const uint64_t,
+                                         const uint64_t totalSize,
+                                         const bool isResponse)
+{
+    Session_Test* instance = static_cast<Session_Test*>(target);
+    instance->compare(isResponse, true);
+    instance->compare(totalSize, instance->m_multiBlockMessage.size() + 9);
+
+    return instance->m_externalBuffer;
+}
+
+/**
+ * @brief abortAllocationCallback
+ */
+DataBuffer* abortAllocationCallback(void* target,
+                                    Session*,
+                                    const uint64_t multiblockId,
+                                    const uint64_t,
+                                    const bool)
+{
+    Session_Test* instance = static_cast<Session_Test*>(target);
+    instance->m_abortedMultiblockId = multiblockId;
+
+    // abort the transfer on the side of the sender, while the first part is received
+    instance->compare(instance->m_abortSession->abortMultiblockMessage(multiblockId), true);
+
+    return nullptr;
+}
+
+/**
+ * @brief multiblockPartCallback
+ */
+void multiblockPartCallback(void* target,
+                            Session*,
+                            const uint64_t,
+                            const uint64_t offset,
+                            const void* data,
+                            const uint64_t size,
+                            const bool isLast)
+{
+    Session_Test* instance = static_cast<Session_Test*>(target);
+    instance->compare(instance->m_streamedLastPart, false);
+
+    if(instance->m_streamedMessage.size() < offset + size) {
+        instance->m_streamedMessage.resize(offset + size);
+    }
+    memcpy(&instance->m_streamedMessage[offset], data, size);
+    instance->m_streamedLastPart = isLast;
+}
+
+/**
+ * @brief resumePartCallback
+ */
+void resumePartCallback(void* target,
+                        Session* session,
+                        const uint64_t,
+                        const uint64_t offset,
+                        const void* data,
+                        const uint64_t size,
+                        const bool isLast)
+{
+    Session_Test* instance = static_cast<Session_Test*>(target);
+    instance->m_numberOfResumeParts++;
+
+    if(instance->m_streamedMessage.size() < offset + size) {
+        instance->m_streamedMessage.resize(offset + size);
+    }
+    memcpy(&instance->m_streamedMessage[offset], data, size);
+    instance->m_streamedLastPart = isLast;
+
+    // lose the connection in the middle of the transfer
+    if(instance->m_dropConnection
+            && offset >= instance->m_resumeMessage.size() / 2)
+    {
+        instance->m_dropConnection = false;
+        session->closeSession(session->sessionError, false);
+    }
+}
+
+/**
+ * @brief asyncSendCallback
+ */
+void asyncSendCallback(void* target,
+                       Session*,
+                       const uint64_t sendId,
+                       const bool success,
+                       const uint64_t bytesSent,
+                       ErrorContainer &)
+{
+    Session_Test* instance = static_cast<Session_Test*>(target);
+    instance->m_asyncSendId = sendId;
+    instance->m_asyncSuccess = success;
+    instance->m_asyncBytesSent = bytesSent;
+}
+
+/**
+ * @brief asyncResponseCallback
+ */
+void asyncResponseCallback(void* target,
+                           Session*,
+                           const uint64_t,
+                           DataBuffer* response)
+{
+    Session_Test* instance = static_cast<Session_Test*>(target);
+    if(response == nullptr) {
+        return;
+    }
+
+    instance->m_asyncResponse = std::string(static_cast<const char*>(response->data),
+                                            response->usedBufferSize);
+    SessionController::m_sessionController->releaseBuffer(response);
 }
 
 /**
  * @brief errorCallback
  */
 void errorCallback(Kitsunemimi::Sakura::Session*,
-                   const uint8_t,
+                   const uint8_t errorCode,
                    const std::string message)
 {
+    if(errorCode == Session::errorCodes::MULTIBLOCK_FAILED)
+    {
+        Session_Test::m_instance->m_numberOfMultiblockErrors++;
+        Session_Test::m_instance->m_lastMultiblockError = message;
+    }
     std::cout<<"ERROR: "<<message<<std::endl;
 }
 
@@ -113,10 +262,16 @@ void sessionCreateCallback(Kitsunemimi::Sakura::Session* session,
     session->setStreamCallback(Session_Test::m_instance, &streamDataCallback);
     session->setRequestCallback(Session_Test::m_instance, &standaloneDataCallback);
 
-    Session_Test::m_instance->compare(session->sessionId(), (uint32_t)131073);
+    // only the first connection has a fixed session-id
+    if(Session_Test::m_instance->m_numberOfInitSessions < 2) {
+        Session_Test::m_instance->compare(session->sessionId(), (uint32_t)131073);
+    }
     Session_Test::m_instance->m_numberOfInitSessions++;
     Session_Test::m_instance->compare(sessionIdentifier, std::string("test"));
     Session_Test::m_instance->m_testSession = session;
+    if(session->isClientSide() == false) {
+        Session_Test::m_instance->m_serverSession = session;
+    }
 }
 
 void sessionCloseCallback(Kitsunemimi::Sakura::Session*,
@@ -237,11 +392,24 @@ Session_Test::runTest()
                                                             &sessionCloseCallback,
                                                             &errorCallback);
 
+    // small single-message-size to force multiblock-messages for the bigger test-message
+    TEST_EQUAL(m_controller->setMaximumSingleSize(1024), true);
+
+    // limits for incomplete multiblock-messages
+    TEST_EQUAL(m_controller->setMultiblockLimits(0, 1024*1024, 10), false);
+    TEST_EQUAL(m_controller->setMultiblockLimits(2*1024*1024, 1024*1024, 10), false);
+    TEST_EQUAL(m_controller->setMultiblockLimits(1024*1024, 4*1024*1024, 10), true);
+
+    // the buffer-allocator can only be changed before the first server is created
+    TEST_EQUAL(m_controller->setBufferAllocator(nullptr), true);
+
     TEST_EQUAL(m_controller->addUnixDomainServer("/tmp/sock.uds", error), 1);
-    bool isNullptr = m_controller->startUnixDomainSession("/tmp/sock.uds",
-                                                          "test",
-                                                          "test",
-                                                          error) == nullptr;
+    TEST_EQUAL(m_controller->setBufferAllocator(nullptr), false);
+    Session* clientSession = m_controller->startUnixDomainSession("/tmp/sock.uds",
+                                                                  "test",
+                                                                  "test",
+                                                                  error);
+    bool isNullptr = clientSession == nullptr;
     TEST_EQUAL(isNullptr, false);
 
 
@@ -264,6 +432,16 @@ Session_Test::runTest()
     TEST_EQUAL(ret, true);
     usleep(100000);
 
+    // test stream-messages with coalescing
+    ret = m_testSession->enableCoalescing(64*1024, 1000);
+    TEST_EQUAL(ret, true);
+    sendTestMessages(m_testSession);
+    ret = m_testSession->flush(error);
+    TEST_EQUAL(ret, true);
+    ret = m_testSession->disableCoalescing(error);
+    TEST_EQUAL(ret, true);
+    usleep(100000);
+
     // test request with single-block
     DataBuffer* resp = m_testSession->sendRequest(m_singleBlockMessage.c_str(),
                                                   m_singleBlockMessage.size(),
@@ -274,14 +452,223 @@ Session_Test::runTest()
     TEST_EQUAL(response1, expectedReponse1);
 
     // test request with multi-block
+    uint64_t multiblockRequestId = 0;
     resp = m_testSession->sendRequest(m_multiBlockMessage.c_str(),
                                       m_multiBlockMessage.size(),
                                       10,
+                                      multiblockRequestId,
                                       error);
+    TEST_EQUAL(multiblockRequestId != 0, true);
     const std::string expectedReponse2 = m_multiBlockMessage + "_response";
     const std::string response2(static_cast<const char*>(resp->data), resp->usedBufferSize);
     TEST_EQUAL(response2, expectedReponse2);
 
+    // test request with a timeout in milliseconds
+    resp = m_testSession->sendRequest(m_singleBlockMessage.c_str(),
+                                      m_singleBlockMessage.size(),
+                                      std::chrono::milliseconds(2000),
+                                      error);
+    isNullptr = resp == nullptr;
+    TEST_EQUAL(isNullptr, false);
+    const std::string response7(static_cast<const char*>(resp->data), resp->usedBufferSize);
+    TEST_EQUAL(response7, expectedReponse1);
+
+    // test asynchronous request with single-block and callback
+    const uint64_t requestId = m_testSession->sendRequestAsync(m_singleBlockMessage.c_str(),
+                                                               m_singleBlockMessage.size(),
+                                                               10,
+                                                               this,
+                                                               &asyncResponseCallback,
+                                                               error);
+    TEST_EQUAL(requestId != 0, true);
+    usleep(100000);
+    TEST_EQUAL(m_asyncResponse, expectedReponse1);
+
+    // test asynchronous request with multi-block and future
+    std::future<DataBuffer*> future = m_testSession->sendRequestAsync(m_multiBlockMessage.c_str(),
+                                                                      m_multiBlockMessage.size(),
+                                                                      10,
+                                                                      error);
+    resp = future.get();
+    isNullptr = resp == nullptr;
+    TEST_EQUAL(isNullptr, false);
+    const std::string response6(static_cast<const char*>(resp->data), resp->usedBufferSize);
+    TEST_EQUAL(response6, expectedReponse2);
+
+    // test normal message with multi-block, which is streamed part by part
+    m_serverSession->setMultiblockPartCallback(this, &multiblockPartCallback);
+    ret = clientSession->sendNormalMessage(m_multiBlockMessage.c_str(),
+                                           m_multiBlockMessage.size(),
+                                           error);
+    TEST_EQUAL(ret, true);
+    usleep(100000);
+    TEST_EQUAL(m_streamedLastPart, true);
+    TEST_EQUAL(m_streamedMessage, m_multiBlockMessage);
+
+    // test resumable message, which is resumed after it was already complete, so it is not
+    // delivered again
+    m_streamedMessage = "";
+    m_streamedLastPart = false;
+    uint64_t multiblockId = 0;
+    ret = clientSession->sendResumableMessage(m_multiBlockMessage.c_str(),
+                                              m_multiBlockMessage.size(),
+                                              multiblockId,
+                                              error);
+    TEST_EQUAL(ret, true);
+    TEST_EQUAL(multiblockId != 0, true);
+    usleep(100000);
+    TEST_EQUAL(m_streamedLastPart, true);
+    TEST_EQUAL(m_streamedMessage, m_multiBlockMessage);
+    m_streamedMessage = "";
+    m_streamedLastPart = false;
+    ret = clientSession->sendResumableMessage(m_multiBlockMessage.c_str(),
+                                              m_multiBlockMessage.size(),
+                                              multiblockId,
+                                              error);
+    TEST_EQUAL(ret, true);
+    usleep(100000);
+    TEST_EQUAL(m_streamedLastPart, false);
+    TEST_EQUAL(m_streamedMessage, std::string(""));
+
+    // test asynchronous normal message with multi-block
+    m_streamedMessage = "";
+    m_streamedLastPart = false;
+    const uint64_t sendId = clientSession->sendNormalMessageAsync(m_multiBlockMessage.c_str(),
+                                                                  m_multiBlockMessage.size(),
+                                                                  this,
+                                                                  &asyncSendCallback,
+                                                                  error);
+    TEST_EQUAL(sendId != 0, true);
+    usleep(100000);
+    TEST_EQUAL(m_asyncSendId, sendId);
+    TEST_EQUAL(m_asyncSuccess, true);
+    TEST_EQUAL(m_asyncBytesSent, static_cast<uint64_t>(m_multiBlockMessage.size()));
+    TEST_EQUAL(m_streamedLastPart, true);
+    TEST_EQUAL(m_streamedMessage, m_multiBlockMessage);
+    m_serverSession->setMultiblockPartCallback(nullptr, nullptr);
+
+    // test requests, which are given as view to the request-view-callback and copied with
+    // detachData to keep them after the callback
+    m_serverSession->setRequestViewCallback(this, &requestViewCallback);
+    resp = clientSession->sendRequest(m_singleBlockMessage.c_str(),
+                                      m_singleBlockMessage.size(),
+                                      10,
+                                      error);
+    isNullptr = resp == nullptr;
+    TEST_EQUAL(isNullptr, false);
+    const std::string response8(static_cast<const char*>(resp->data), resp->usedBufferSize);
+    TEST_EQUAL(response8, expectedReponse1);
+    SessionController::m_sessionController->releaseBuffer(resp);
+    resp = clientSession->sendRequest(m_multiBlockMessage.c_str(),
+                                      m_multiBlockMessage.size(),
+                                      10,
+                                      error);
+    isNullptr = resp == nullptr;
+    TEST_EQUAL(isNullptr, false);
+    const std::string response9(static_cast<const char*>(resp->data), resp->usedBufferSize);
+    TEST_EQUAL(response9, expectedReponse2);
+    SessionController::m_sessionController->releaseBuffer(resp);
+    TEST_EQUAL(m_numberOfRequestViews, static_cast<uint32_t>(2));
+    const std::string detachedRequest(static_cast<const char*>(m_detachedRequest->data),
+                                      m_detachedRequest->usedBufferSize);
+    TEST_EQUAL(detachedRequest, m_multiBlockMessage);
+    SessionController::m_sessionController->releaseBuffer(m_detachedRequest);
+    m_detachedRequest = nullptr;
+
+    // without request-view-callback the requests are given to the request-callback again
+    m_serverSession->setRequestViewCallback(nullptr, nullptr);
+    resp = clientSession->sendRequest(m_singleBlockMessage.c_str(),
+                                      m_singleBlockMessage.size(),
+                                      10,
+                                      error);
+    isNullptr = resp == nullptr;
+    TEST_EQUAL(isNullptr, false);
+    SessionController::m_sessionController->releaseBuffer(resp);
+    TEST_EQUAL(m_numberOfRequestViews, static_cast<uint32_t>(2));
+
+    // test abort of a multiblock-message in the middle of the transfer. The receiver releases the
+    // partial message and reports the abort by the error-callback.
+    const std::string abortMessage(256*1024, 'a');
+    const uint32_t numberOfMultiblockErrors = m_numberOfMultiblockErrors;
+    m_abortSession = clientSession;
+    m_abortedMultiblockId = 0;
+    m_serverSession->setMultiblockAllocationCallback(this, &abortAllocationCallback);
+    uint64_t abortedId = 0;
+    ret = clientSession->sendNormalMessage(abortMessage.c_str(),
+                                           abortMessage.size(),
+                                           abortedId,
+                                           error);
+    TEST_EQUAL(ret, false);
+    TEST_EQUAL(abortedId, m_abortedMultiblockId);
+    usleep(100000);
+    TEST_EQUAL(m_numberOfMultiblockErrors, numberOfMultiblockErrors + 1);
+    const uint64_t usedMemory = SessionHandler::m_sessionHandler->getUsedMultiblockMemory();
+    TEST_EQUAL(usedMemory, static_cast<uint64_t>(0));
+    m_serverSession->setMultiblockAllocationCallback(nullptr, nullptr);
+
+    // test multiblock-message, which is bigger than the memory-limit of the session. The receiver
+    // rejects it with an error-message, aborts the transfer and ignores the remaining parts.
+    const std::string rejectedMessage(2*1024*1024, 'r');
+    const uint32_t numberOfRejectErrors = m_numberOfMultiblockErrors;
+    m_lastMultiblockError = "";
+    ret = clientSession->sendNormalMessage(rejectedMessage.c_str(),
+                                           rejectedMessage.size(),
+                                           error);
+    TEST_EQUAL(ret, false);
+    usleep(100000);
+    TEST_EQUAL(m_numberOfMultiblockErrors, numberOfRejectErrors + 1);
+    const bool limitExceeded = m_lastMultiblockError.find("memory-limit") != std::string::npos;
+    TEST_EQUAL(limitExceeded, true);
+    const uint64_t memoryAfterReject = SessionHandler::m_sessionHandler->getUsedMultiblockMemory();
+    TEST_EQUAL(memoryAfterReject, static_cast<uint64_t>(0));
+
+    // the session can still be used after the rejected message
+    resp = m_testSession->sendRequest(m_multiBlockMessage.c_str(),
+                                      m_multiBlockMessage.size(),
+                                      10,
+                                      error);
+    isNullptr = resp == nullptr;
+    TEST_EQUAL(isNullptr, false);
+
+    // test abort of a multiblock-message, which is not sent anymore
+    TEST_EQUAL(clientSession->abortMultiblockMessage(multiblockId), false);
+
+    // test request with multi-block, where the response is written into an external buffer
+    m_externalBuffer = new DataBuffer(calcBytesToBlocks(m_multiBlockMessage.size() + 9));
+    m_testSession->setMultiblockAllocationCallback(this, &multiblockAllocationCallback);
+    resp = m_testSession->sendRequest(m_multiBlockMessage.c_str(),
+                                      m_multiBlockMessage.size(),
+                                      10,
+                                      error);
+    TEST_EQUAL(resp, m_externalBuffer);
+    const std::string response5(static_cast<const char*>(resp->data), resp->usedBufferSize);
+    TEST_EQUAL(response5, expectedReponse2);
+    m_testSession->setMultiblockAllocationCallback(nullptr, nullptr);
+    delete m_externalBuffer;
+
+    // test request with multi-block over an additional connection
+    ret = m_controller->addUnixDomainPath(clientSession, "/tmp/sock.uds", "test", error);
+    TEST_EQUAL(ret, true);
+    TEST_EQUAL(clientSession->getNumberOfPaths(), static_cast<uint32_t>(2));
+    resp = clientSession->sendRequest(m_multiBlockMessage.c_str(),
+                                      m_multiBlockMessage.size(),
+                                      10,
+                                      error);
+    const std::string response4(static_cast<const char*>(resp->data), resp->usedBufferSize);
+    TEST_EQUAL(response4, expectedReponse2);
+    SessionController::m_sessionController->releaseBuffer(resp);
+
+    // test request with reserved frame
+    Session::ReservedFrame frame;
+    ret = m_testSession->reserveFrame(frame, m_singleBlockMessage.size());
+    TEST_EQUAL(ret, true);
+    memcpy(frame.payload, m_singleBlockMessage.c_str(), m_singleBlockMessage.size());
+    resp = m_testSession->commitRequest(frame, 10, error);
+    const std::string response3(static_cast<const char*>(resp->data), resp->usedBufferSize);
+    TEST_EQUAL(response3, expectedReponse1);
+    isNullptr = frame.buffer == nullptr;
+    TEST_EQUAL(isNullptr, true);
+
     LOG_DEBUG("TEST: close session again");
     ret = m_testSession->closeSession(error);
     TEST_EQUAL(ret, true);
@@ -292,6 +679,58 @@ Session_Test::runTest()
     TEST_EQUAL(m_numberOfInitSessions, 2);
     TEST_EQUAL(m_numberOfEndSessions, 2);
 
+    // test resumable message, where the connection is lost in the middle of the transfer and
+    // which is resumed with a new session
+    m_resumeMessage.resize(256*1024);
+    for(uint64_t i = 0; i < m_resumeMessage.size(); i++) {
+        m_resumeMessage[i] = static_cast<char>('a' + (i % 26));
+    }
+    Session* resumeSession = m_controller->startUnixDomainSession("/tmp/sock.uds",
+                                                                  "test",
+                                                                  "test",
+                                                                  error);
+    isNullptr = resumeSession == nullptr;
+    TEST_EQUAL(isNullptr, false);
+    Session* lostSession = m_serverSession;
+    lostSession->setMultiblockPartCallback(this, &resumePartCallback);
+    m_streamedMessage = "";
+    m_streamedLastPart = false;
+    m_dropConnection = true;
+    multiblockId = 0;
+    ret = resumeSession->sendResumableMessage(m_resumeMessage.c_str(),
+                                              m_resumeMessage.size(),
+                                              multiblockId,
+                                              error);
+    TEST_EQUAL(ret, false);
+    TEST_EQUAL(m_streamedLastPart, false);
+    usleep(100000);
+
+    // the partial message is kept after the session was deleted
+    delete resumeSession;
+    delete lostSession;
+    resumeSession = m_controller->startUnixDomainSession("/tmp/sock.uds",
+                                                         "test",
+                                                         "test",
+                                                         error);
+    isNullptr = resumeSession == nullptr;
+    TEST_EQUAL(isNullptr, false);
+    m_serverSession->setMultiblockPartCallback(this, &resumePartCallback);
+    m_numberOfResumeParts = 0;
+    ret = resumeSession->sendResumableMessage(m_resumeMessage.c_str(),
+                                              m_resumeMessage.size(),
+                                              multiblockId,
+                                              error);
+    TEST_EQUAL(ret, true);
+    usleep(100000);
+    TEST_EQUAL(m_streamedLastPart, true);
+    TEST_EQUAL(m_streamedMessage, m_resumeMessage);
+    TEST_EQUAL(m_numberOfResumeParts < 256, true);
+    resumeSession->closeSession(error);
+    usleep(100000);
+
+    TEST_EQUAL(m_numberOfInitSessions, 6);
+    TEST_EQUAL(m_numberOfEndSessions, 6);
+
     delete m_controller;
 }
 
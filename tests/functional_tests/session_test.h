@@ -63,6 +63,23 @@ public:
     uint32_t m_numberOfEndSessions = 0;
 
     Session* m_testSession = nullptr;
+    Session* m_serverSession = nullptr;
+    DataBuffer* m_externalBuffer = nullptr;
+    std::string m_streamedMessage = "";
+    bool m_streamedLastPart = false;
+    uint64_t m_asyncSendId = 0;
+    uint64_t m_asyncBytesSent = 0;
+    bool m_asyncSuccess = false;
+    std::string m_asyncResponse = "";
+    std::string m_resumeMessage = "";
+    bool m_dropConnection = false;
+    uint32_t m_numberOfResumeParts = 0;
+    Session* m_abortSession = nullptr;
+    uint64_t m_abortedMultiblockId = 0;
+    uint32_t m_numberOfMultiblockErrors = 0;
+    std::string m_lastMultiblockError = "";
+    uint32_t m_numberOfRequestViews = 0;
+    DataBuffer* m_detachedRequest = nullptr;
 
 private:
     void sendTestMessages(Session *session);
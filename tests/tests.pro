@@ -5,6 +5,8 @@ CONFIG += c++17
 
 SUBDIRS = \
     functional_tests \
-    memory_leak_tests
+    memory_leak_tests \
+    benchmark_tests \
+    coroutine_tests
 
 tests.depends = src